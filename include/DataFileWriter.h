@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdio>
+
+#include "VUtils.h"
+#include "DataWriter.h"
+
+// DataWriter which streams into a file rather than growing without bound
+//  Bytes are buffered, then appended to a temporary file beside the destination.
+//  Commit syncs the file to disk and renames it over the destination, so
+//  an interrupted write never replaces the previous file
+//  Positions (and so SubWrite) are relative to the unflushed buffer,
+//  so Flush must only be called between complete records
+class DataFileWriter : public DataWriter {
+private:
+    // Streams only keep a reference, so the buffer may be constructed after them
+    BYTES_t m_buffer;
+
+    fs::path m_path;
+    fs::path m_tempPath;
+    FILE* m_file = nullptr;
+
+    // Buffered bytes at which Flush writes them out
+    size_t m_flushSize;
+
+    // Bytes already appended to the file
+    size_t m_written = 0;
+
+public:
+    // Open a temporary file for the destination
+    //  Throws if it cannot be created
+    explicit DataFileWriter(fs::path path, size_t flushSize = 1024 * 1024);
+
+    DataFileWriter(const DataFileWriter&) = delete;
+
+    // Discards the temporary file if not committed
+    ~DataFileWriter();
+
+    // Append the buffered bytes to the file once enough have accumulated
+    void Flush(bool force = false);
+
+    // Append already serialized bytes to the file
+    void Append(const BYTES_t& bytes);
+
+    // Flush, sync and move the file into place
+    //  Throws on failure
+    void Commit();
+
+    // Total number of bytes written
+    size_t Written() const {
+        return m_written + Position();
+    }
+};
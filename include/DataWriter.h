@@ -114,6 +114,11 @@ public:
         //WriteSomeBytes(in.data(), in.size());
     }
 
+    // Writes bytes as-is, without a length prefix
+    void WriteRaw(BYTE_VIEW_t in) {
+        WriteSomeBytes(in.data(), in.size());
+    }
+
     // Writes a string
     void Write(std::string_view in) {
         auto length = in.length();
@@ -42,6 +42,41 @@ namespace ankerl::unordered_dense {
         }
     };
 
+    // Hash ignoring ascii case
+    struct istring_hash {
+        using is_transparent = void;
+        using is_avalanching = void;
+
+        [[nodiscard]] auto operator()(std::string_view str) const noexcept -> uint64_t {
+            // fnv-1a over the lowered string, then mixed
+            uint64_t h = 14695981039346656037ULL;
+            for (char c : str) {
+                h ^= (uint8_t)((c >= 'A' && c <= 'Z') ? c + ('a' - 'A') : c);
+                h *= 1099511628211ULL;
+            }
+            return ankerl::unordered_dense::detail::wyhash::hash(h);
+        }
+    };
+
+    // Equality ignoring ascii case
+    struct istring_equal {
+        using is_transparent = void;
+
+        [[nodiscard]] bool operator()(std::string_view a, std::string_view b) const noexcept {
+            if (a.size() != b.size())
+                return false;
+
+            for (size_t i = 0; i < a.size(); i++) {
+                char x = a[i], y = b[i];
+                if (x >= 'A' && x <= 'Z') x += 'a' - 'A';
+                if (y >= 'A' && y <= 'Z') y += 'a' - 'A';
+                if (x != y)
+                    return false;
+            }
+            return true;
+        }
+    };
+
 } // namespace ankerl::unordered_dense
 
 /*
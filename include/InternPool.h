@@ -0,0 +1,139 @@
+#pragma once
+
+#include <string_view>
+#include <cassert>
+
+#include "VUtils.h"
+
+// Reference-counted storage for immutable string-like values
+//  Equal values can be interned so every holder shares a single allocation.
+//  Values acquired without interning are still reference counted, but are
+//  never matched against, so they behave as plain owned copies
+template<typename T>
+class InternPool {
+public:
+    class Entry {
+        friend class InternPool;
+
+    private:
+        T m_value;
+        mutable uint32_t m_refs = 1;
+        bool m_interned = false;
+
+    public:
+        explicit Entry(T value) : m_value(std::move(value)) {}
+
+        const T& Value() const {
+            return m_value;
+        }
+
+        std::string_view View() const {
+            return std::string_view(m_value.data(), m_value.size());
+        }
+
+        uint32_t RefCount() const {
+            return m_refs;
+        }
+
+        void AddRef() const {
+            m_refs++;
+        }
+    };
+
+private:
+    struct Hash {
+        using is_transparent = void;
+        using is_avalanching = void;
+
+        uint64_t operator()(std::string_view view) const {
+            return ankerl::unordered_dense::hash<std::string_view>{}(view);
+        }
+
+        uint64_t operator()(const Entry* entry) const {
+            return (*this)(entry->View());
+        }
+    };
+
+    struct Equal {
+        using is_transparent = void;
+
+        static std::string_view View(std::string_view view) { return view; }
+        static std::string_view View(const Entry* entry) { return entry->View(); }
+
+        template<typename A, typename B>
+        bool operator()(const A& a, const B& b) const {
+            return View(a) == View(b);
+        }
+    };
+
+    UNORDERED_SET_t<Entry*, Hash, Equal> m_interned;
+
+    // Number of live entries (interned or not)
+    size_t m_count = 0;
+
+    // Bytes held by live entries
+    size_t m_bytes = 0;
+
+public:
+    InternPool() = default;
+    InternPool(const InternPool&) = delete;
+
+    ~InternPool() {
+        for (auto&& entry : m_interned)
+            delete entry;
+    }
+
+    // Get an entry holding the value
+    //  The caller owns one reference and must Release it
+    const Entry* Acquire(T value, bool intern) {
+        if (intern) {
+            auto&& find = m_interned.find(std::string_view(value.data(), value.size()));
+            if (find != m_interned.end()) {
+                (*find)->AddRef();
+                return *find;
+            }
+        }
+
+        auto entry = new Entry(std::move(value));
+        m_count++;
+        m_bytes += sizeof(Entry) + entry->m_value.capacity();
+
+        if (intern) {
+            entry->m_interned = true;
+            m_interned.insert(entry);
+        }
+
+        return entry;
+    }
+
+    // Drop a reference, freeing the entry once unreferenced
+    void Release(const Entry* entry) {
+        if (!entry)
+            return;
+
+        assert(entry->m_refs > 0);
+        if (--entry->m_refs)
+            return;
+
+        if (entry->m_interned)
+            m_interned.erase(const_cast<Entry*>(entry));
+
+        m_count--;
+        m_bytes -= sizeof(Entry) + entry->m_value.capacity();
+        delete entry;
+    }
+
+    // Number of distinct live values
+    size_t size() const {
+        return m_count;
+    }
+
+    // Number of values available for sharing
+    size_t InternedCount() const {
+        return m_interned.size();
+    }
+
+    size_t GetTotalAlloc() const {
+        return m_bytes + m_interned.size() * sizeof(Entry*);
+    }
+};
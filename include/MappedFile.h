@@ -0,0 +1,40 @@
+#pragma once
+
+#include "VUtils.h"
+
+// Read-only mapping of a whole file into memory
+//  Pages are only read from disk as they are touched, and the
+//  view stays valid for as long as the mapping is open
+class MappedFile {
+private:
+    BYTE_t* m_data = nullptr;
+    size_t m_size = 0;
+
+#ifdef _WIN32
+    void* m_file = nullptr;
+    void* m_mapping = nullptr;
+#endif
+
+public:
+    MappedFile() = default;
+    MappedFile(const MappedFile&) = delete;
+
+    ~MappedFile() {
+        Close();
+    }
+
+    // Map a file
+    //  Returns false if the file could not be opened or mapped
+    bool Open(const fs::path& path);
+
+    void Close();
+
+    // The mapped bytes must not be written to
+    BYTE_VIEW_t View() const {
+        return BYTE_VIEW_t(m_data, m_size);
+    }
+
+    size_t size() const {
+        return m_size;
+    }
+};
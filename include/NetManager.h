@@ -7,6 +7,7 @@
 #include "Vector.h"
 #include "WorldManager.h"
 #include "HashUtils.h"
+#include "ZoneManager.h"
 
 class INetManager {
     friend class IModManager;
@@ -20,6 +21,12 @@ private:
     std::vector<std::unique_ptr<Peer>> m_connectedPeers;
     std::vector<Peer*> m_onlinePeers;
 
+    // Lookups over online peers
+    UNORDERED_MAP_t<OWNER_t, Peer*> m_peersByUUID;
+    UNORDERED_MAP_t<std::string, Peer*, ankerl::unordered_dense::istring_hash, ankerl::unordered_dense::istring_equal> m_peersByName;
+    UNORDERED_MAP_t<std::string, Peer*, ankerl::unordered_dense::string_hash, std::equal_to<>> m_peersByHost;
+    UNORDERED_MAP_t<ZoneID, std::vector<Peer*>> m_peersByZone;
+
     std::list<std::pair<std::string, std::pair<nanoseconds, nanoseconds>>> m_sortedSessions;
     UNORDERED_MAP_t<std::string, int32_t, ankerl::unordered_dense::string_hash> m_sessionIndexes;
 
@@ -36,6 +43,9 @@ private:
     void OnPeerQuit(Peer& peer);
     void OnPeerDisconnect(Peer& peer);
 
+    void IndexPeer(Peer& peer);
+    void UnindexPeer(Peer& peer);
+
 public:
     void PostInit();
     void Update();
@@ -46,9 +56,35 @@ public:
     // Finds a peer by either name, uuid or host
     Peer* GetPeer(std::string_view any);
     Peer* GetPeerByUUID(OWNER_t uuid);
+    // Names are matched ignoring case
     Peer* GetPeerByName(std::string_view name);
     Peer* GetPeerByHost(std::string_view host);
 
+    // Get the online peers within a radius
+    std::vector<Peer*> GetPeersNear(Vector3f pos, float radius);
+
+    // Visit the online peers within a square of zones
+    //  Peers must not be moved during the visit
+    template<typename F>
+    void ForEachPeer(ZoneID zone, int radius, F&& func) {
+        for (auto z = zone.y - radius; z <= zone.y + radius; z++) {
+            for (auto x = zone.x - radius; x <= zone.x + radius; x++) {
+                auto&& find = m_peersByZone.find(ZoneID(x, z));
+                if (find != m_peersByZone.end()) {
+                    for (auto&& peer : find->second)
+                        func(*peer);
+                }
+            }
+        }
+    }
+
+    // Change the name of an online peer
+    //  Returns false if another peer has the name
+    bool RenamePeer(Peer& peer, std::string name);
+
+    // Change the position of a peer
+    void MovePeer(Peer& peer, Vector3f pos);
+
     void OnPeerConnect(Peer& peer);
 
     // Kick a player by identifier
@@ -81,10 +81,41 @@ public:
     bool m_gatedPlaythrough = false;
 
 public:
-    UNORDERED_MAP_t<ZDOID, std::pair<ZDO::Rev, float>> m_zdos;
+    // The revision of a ZDO last exchanged with this peer
+    struct KnownZDO {
+        uint32_t m_generation = 0; // generation of the pool slot this entry belongs to
+        ZDO::Rev m_rev;
+        float m_time = 0;
+    };
+
+private:
+    static constexpr size_t KNOWN_ZDO_PAGE_SIZE = 256;
+    using KnownZDOPage = std::array<KnownZDO, KNOWN_ZDO_PAGE_SIZE>;
+
+    // Known ZDOs indexed by the pool slot of the ZDO
+    //  Pages are only allocated for slots this peer has seen
+    //  Entries no longer count once their slot generation changes,
+    //  so destroyed ZDOs are forgotten without being erased
+    std::vector<std::unique_ptr<KnownZDOPage>> m_knownZDOs;
+
+public:
     UNORDERED_SET_t<ZDOID> m_forceSend;
     UNORDERED_SET_t<ZDOID> m_invalidSector;
 
+    // ZDOs within range that may be outdated on this peer
+    //  Maintained incrementally by the ZDOManager as ZDOs change
+    //  and as the peer moves between zones
+    UNORDERED_SET_t<ZDOID> m_syncQueue;
+
+    struct ZoneWatermark {
+        uint64_t m_seq = 0;
+        bool m_near = false; // whether all ZDOs were tracked, or only distant ZDOs
+    };
+
+    // The latest zone change sequence that has been pulled into the sync queue
+    //  Zones whose sequence has not advanced past this are skipped
+    UNORDERED_MAP_t<ZoneID, ZoneWatermark> m_zoneWatermarks;
+
 private:
     void Update();
 
@@ -94,10 +125,19 @@ private:
         m_forceSend.insert(id);
     }
 
-    bool IsOutdatedZDO(ZDO& zdo, decltype(m_zdos)::iterator& outItr);
+    // Get the revision of a ZDO this peer knows
+    //  Returns null if the peer does not know the ZDO
+    KnownZDO* GetKnownZDO(const ZDO& zdo);
+    // Record the revision of a ZDO this peer now knows
+    void SetKnownZDO(const ZDO& zdo, ZDO::Rev rev, float time);
+    // Forget a ZDO
+    //  Returns whether the ZDO was known
+    bool ForgetZDO(const ZDO& zdo);
+
+    bool IsOutdatedZDO(ZDO& zdo, KnownZDO*& outKnown);
     bool IsOutdatedZDO(ZDO& zdo) {
-        decltype(m_zdos)::iterator outItr;
-        return IsOutdatedZDO(zdo, outItr);
+        KnownZDO* outKnown;
+        return IsOutdatedZDO(zdo, outKnown);
     }
 
 public:
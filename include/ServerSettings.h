@@ -103,12 +103,20 @@ struct ServerSettings {
     bool            worldVegetation;
     bool            worldCreatures;
     uint32_t        worldHeightmapThreads;
+    unsigned int    worldSaveThreads;   // threads which serialize saves (besides the save thread)
+    seconds         worldJournalInterval; // how often changes are journaled between saves; set to 0 to disable
+    unsigned int    worldBackupThreads; // threads which compress backups (besides the save thread)
+    unsigned int    worldBackupDeltas;  // delta backups made between full backups; set to 0 to disable
+    seconds         worldPagingDelay;   // how long zones stay loaded after peers leave; set to 0 to disable
     
     unsigned int    zdoMaxCongestion;    // congestion rate
     unsigned int    zdoMinCongestion;    // congestion rate
     milliseconds    zdoSendInterval;
     seconds         zdoAssignInterval;
     AssignAlgorithm zdoAssignAlgorithm;
+    float           zdoAssignHysteresis; // meters an owner may stray past its area before losing zdos
+    bool            zdoInternMembers;   // share equal string/byte members between zdos
+    unsigned int    zdoSyncThreads;     // threads which plan zdo sends (besides the main thread)
         
     bool            dungeonsEnabled;
     bool            dungeonsEndcapsEnabled;
@@ -0,0 +1,185 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
+
+// Chunked object pool handing out stable pointers
+//  Objects are constructed in place within fixed-size chunks that never move,
+//  so pointers remain valid until the object is freed. Freed slots are
+//  recycled through a free list and their generation is bumped, which lets
+//  handles detect whether the object they referred to is gone
+template<typename T, size_t ChunkSize = 4096>
+class SlabPool {
+public:
+    // Weak reference to a pooled object
+    //  Resolves to null once the object is freed, even if the slot is reused
+    struct Handle {
+        uint32_t m_index = std::numeric_limits<uint32_t>::max();
+        uint32_t m_generation = 0;
+
+        bool operator==(const Handle& other) const = default;
+        explicit operator bool() const { return m_index != std::numeric_limits<uint32_t>::max(); }
+    };
+
+private:
+    struct Slot {
+        // Must be first so a T* can be converted back to its Slot
+        alignas(T) std::byte m_storage[sizeof(T)];
+        uint32_t m_index;
+        uint32_t m_generation;  // odd while the slot is occupied
+        uint32_t m_nextFree;
+
+        T* Get() { return std::launder(reinterpret_cast<T*>(m_storage)); }
+        bool Alive() const { return m_generation & 1; }
+    };
+
+    static_assert(offsetof(Slot, m_storage) == 0);
+
+    static constexpr uint32_t NO_SLOT = std::numeric_limits<uint32_t>::max();
+
+    std::vector<std::unique_ptr<Slot[]>> m_chunks;
+    uint32_t m_freeHead = NO_SLOT;
+    uint32_t m_capacity = 0;
+    size_t m_size = 0;
+
+private:
+    Slot& At(uint32_t index) {
+        return m_chunks[index / ChunkSize][index % ChunkSize];
+    }
+
+    static Slot& SlotOf(const T* ptr) {
+        return *reinterpret_cast<Slot*>(const_cast<T*>(ptr));
+    }
+
+    void Grow() {
+        auto chunk = std::make_unique<Slot[]>(ChunkSize);
+
+        // Link the fresh slots into the free list in ascending order
+        //  so allocations walk memory linearly
+        for (size_t i = 0; i < ChunkSize; i++) {
+            auto&& slot = chunk[i];
+            slot.m_index = m_capacity + (uint32_t)i;
+            slot.m_generation = 0;
+            slot.m_nextFree = (i + 1 < ChunkSize) ? slot.m_index + 1 : m_freeHead;
+        }
+
+        m_freeHead = m_capacity;
+        m_capacity += (uint32_t)ChunkSize;
+        m_chunks.push_back(std::move(chunk));
+    }
+
+public:
+    SlabPool() = default;
+    SlabPool(const SlabPool&) = delete;
+    SlabPool& operator=(const SlabPool&) = delete;
+
+    ~SlabPool() {
+        Clear();
+    }
+
+    // Construct a new object in the pool
+    template<typename... Args>
+    T* New(Args&&... args) {
+        if (m_freeHead == NO_SLOT)
+            Grow();
+
+        auto&& slot = At(m_freeHead);
+        assert(!slot.Alive());
+
+        // Construct before unlinking so a throwing constructor leaves the pool intact
+        T* ptr = new (slot.m_storage) T(std::forward<Args>(args)...);
+
+        m_freeHead = slot.m_nextFree;
+        slot.m_generation++;
+        m_size++;
+        return ptr;
+    }
+
+    // Destroy an object belonging to this pool
+    //  All handles to the object become stale
+    void Delete(T* ptr) {
+        if (!ptr)
+            return;
+
+        auto&& slot = SlotOf(ptr);
+        assert(slot.Alive() && &At(slot.m_index) == &slot);
+
+        ptr->~T();
+        slot.m_generation++;
+        slot.m_nextFree = m_freeHead;
+        m_freeHead = slot.m_index;
+        m_size--;
+    }
+
+    // Get a handle to an object belonging to this pool
+    //  The object must belong to this pool; see FindHandle otherwise
+    Handle GetHandle(const T* ptr) const {
+        auto&& slot = SlotOf(ptr);
+        return { slot.m_index, slot.m_generation };
+    }
+
+    // Get a handle to an object which might not belong to this pool
+    //  Returns an invalid handle if the object is not live within a chunk
+    Handle FindHandle(const T* ptr) const {
+        const auto addr = reinterpret_cast<uintptr_t>(ptr);
+        for (auto&& chunk : m_chunks) {
+            const auto begin = reinterpret_cast<uintptr_t>(chunk.get());
+            const auto end = begin + ChunkSize * sizeof(Slot);
+            if (addr < begin || addr >= end)
+                continue;
+
+            // Within a chunk, but not at the start of a slot
+            if ((addr - begin) % sizeof(Slot) != 0)
+                return {};
+
+            auto&& slot = chunk[(addr - begin) / sizeof(Slot)];
+            if (!slot.Alive())
+                return {};
+
+            Handle handle{ slot.m_index, slot.m_generation };
+            assert(const_cast<SlabPool*>(this)->Get(handle) == ptr);
+            return handle;
+        }
+        return {};
+    }
+
+    // Resolve a handle
+    //  Returns null if the handle is stale or invalid
+    T* Get(Handle handle) {
+        if (handle.m_index >= m_capacity)
+            return nullptr;
+
+        auto&& slot = At(handle.m_index);
+        if (slot.m_generation != handle.m_generation || !slot.Alive())
+            return nullptr;
+
+        return slot.Get();
+    }
+
+    // Ensure space for at least count objects without further chunk allocations
+    void Reserve(size_t count) {
+        while (m_capacity - m_size < count)
+            Grow();
+    }
+
+    // Destroy every live object
+    //  Chunks are kept for reuse
+    void Clear() {
+        for (uint32_t i = 0; i < m_capacity; i++) {
+            auto&& slot = At(i);
+            if (slot.Alive())
+                Delete(slot.Get());
+        }
+    }
+
+    size_t size() const { return m_size; }
+    size_t capacity() const { return m_capacity; }
+
+    // Bytes reserved by chunks, including unused slots
+    size_t GetTotalAlloc() const { return (size_t)m_capacity * sizeof(Slot); }
+};
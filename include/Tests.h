@@ -1265,14 +1265,17 @@ public:
         {
             {
 #ifdef RUN_TESTS
+                // Members of different types may share a hash
+                ZDO zdo;
                 const HASH_t hash1 = 14516234;
-                assert(ZDO::FromShiftHash<float>(ZDO::ToShiftHash<float>(hash1)) == hash1);
-
-                const HASH_t hash2 = 56827231;
-                assert(ZDO::FromShiftHash<int>(ZDO::ToShiftHash<int>(hash2)) == hash2);
-
-                const HASH_t hash3 = 906582783;
-                assert(ZDO::FromShiftHash<std::string>(ZDO::ToShiftHash<std::string>(hash3)) == hash3);
+                zdo.Set(hash1, 3.5f);
+                zdo.Set(hash1, (int32_t)7);
+                zdo.Set(hash1, std::string("shared"));
+
+                assert(zdo.GetFloat(hash1) == 3.5f);
+                assert(zdo.GetInt(hash1) == 7);
+                assert(zdo.GetString(hash1) == "shared");
+                assert(zdo.m_members.size() == 3);
 #endif
             }
 
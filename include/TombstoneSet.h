@@ -0,0 +1,119 @@
+#pragma once
+
+#include <deque>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+
+#include "VUtils.h"
+
+// Set of recently removed keys which forgets them over time
+//  Keys expire after a lifetime, and the oldest are forgotten early once
+//  the capacity is exceeded. A bloom filter in front of the exact set
+//  answers most lookups of keys which were never removed
+template<typename T, typename Hash = ankerl::unordered_dense::hash<T>>
+class TombstoneSet {
+private:
+    static constexpr size_t FILTER_BITS_PER_KEY = 8;
+    static constexpr size_t FILTER_PROBES = 3;
+
+    struct Tombstone {
+        T m_key;
+        float m_time;
+    };
+
+    // Tombstones from oldest to newest
+    std::deque<Tombstone> m_order;
+    UNORDERED_SET_t<T, Hash> m_keys;
+
+    std::vector<uint64_t> m_filter;
+    // Forgotten keys which are still marked in the filter
+    size_t m_stale = 0;
+
+    size_t m_capacity;
+    float m_lifetime;
+
+private:
+    template<typename F>
+    void Probe(const T& key, F&& func) const {
+        const uint64_t hash = Hash{}(key);
+        const uint64_t step = (hash >> 32) | 1;
+        const size_t bits = m_filter.size() * 64;
+
+        for (size_t i = 0; i < FILTER_PROBES; i++)
+            func((hash + i * step) % bits);
+    }
+
+    void Mark(const T& key) {
+        Probe(key, [this](size_t bit) {
+            m_filter[bit / 64] |= 1ULL << (bit % 64);
+        });
+    }
+
+    void PopOldest() {
+        m_keys.erase(m_order.front().m_key);
+        m_order.pop_front();
+        m_stale++;
+    }
+
+    // Clear the marks of forgotten keys
+    void Rebuild() {
+        std::fill(m_filter.begin(), m_filter.end(), 0);
+        for (auto&& tombstone : m_order)
+            Mark(tombstone.m_key);
+        m_stale = 0;
+    }
+
+public:
+    TombstoneSet(size_t capacity, float lifetime)
+        : m_filter(std::max<size_t>(1, (capacity * FILTER_BITS_PER_KEY + 63) / 64)),
+        m_capacity(capacity), m_lifetime(lifetime) {}
+
+    // Remember a removed key
+    void Insert(const T& key, float now) {
+        if (!m_keys.insert(key).second)
+            return;
+
+        m_order.push_back({ key, now });
+        Mark(key);
+
+        if (m_order.size() > m_capacity)
+            PopOldest();
+    }
+
+    bool Contains(const T& key) const {
+        bool marked = true;
+        Probe(key, [&](size_t bit) {
+            marked &= (m_filter[bit / 64] >> (bit % 64)) & 1;
+        });
+
+        return marked && m_keys.contains(key);
+    }
+
+    // Forget keys which have outlived the lifetime
+    void Prune(float now) {
+        while (!m_order.empty() && now - m_order.front().m_time > m_lifetime)
+            PopOldest();
+
+        // Forgotten keys make the filter less selective until rebuilt
+        if (m_stale > m_order.size())
+            Rebuild();
+    }
+
+    void Clear() {
+        m_order.clear();
+        m_keys.clear();
+        std::fill(m_filter.begin(), m_filter.end(), 0);
+        m_stale = 0;
+    }
+
+    size_t size() const {
+        return m_order.size();
+    }
+
+    size_t GetTotalAlloc() const {
+        return m_order.size() * sizeof(Tombstone)
+            + m_keys.size() * sizeof(T)
+            + m_filter.size() * sizeof(uint64_t);
+    }
+};
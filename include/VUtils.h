@@ -421,6 +421,90 @@ public:
     }
 };
 
+// Compresses a stream of chunks into a single frame
+//  Chunks are compressed as they arrive, so the input is never held whole
+class ZStdStreamCompressor {
+    ZSTD_CCtx* m_ctx;
+
+    void SetParameter(ZSTD_cParameter param, int value) {
+        auto status = ZSTD_CCtx_setParameter(this->m_ctx, param, value);
+        if (ZSTD_isError(status))
+            throw std::runtime_error(std::string("failed to set zstd parameter: ") + ZSTD_getErrorName(status));
+    }
+
+    void Stream(const BYTE_t* in, size_t inSize, BYTES_t& out, ZSTD_EndDirective mode) {
+        ZSTD_inBuffer input{ in, inSize, 0 };
+        for (;;) {
+            const auto offset = out.size();
+            out.resize(offset + ZSTD_CStreamOutSize());
+
+            ZSTD_outBuffer output{ out.data() + offset, out.size() - offset, 0 };
+            auto remaining = ZSTD_compressStream2(this->m_ctx, &output, &input, mode);
+            out.resize(offset + output.pos);
+
+            if (ZSTD_isError(remaining))
+                throw std::runtime_error(std::string("failed to compress zstd stream: ") + ZSTD_getErrorName(remaining));
+
+            // Chunks are done once consumed, the end once fully flushed
+            if (mode == ZSTD_e_end ? remaining == 0 : input.pos == input.size)
+                return;
+        }
+    }
+
+public:
+    // Workers compress in the background of Compress calls
+    //  Long distance matching finds repeats across the whole window (up to 2^windowLog bytes)
+    ZStdStreamCompressor(int level, int workers, bool longDistance, int windowLog = 27) {
+        this->m_ctx = ZSTD_createCCtx();
+        if (!this->m_ctx)
+            throw std::runtime_error("failed to init zstd cctx");
+
+        try {
+            SetParameter(ZSTD_c_compressionLevel, level);
+            if (longDistance) {
+                SetParameter(ZSTD_c_enableLongDistanceMatching, 1);
+                SetParameter(ZSTD_c_windowLog, windowLog);
+            }
+        }
+        catch (...) {
+            ZSTD_freeCCtx(m_ctx);
+            throw;
+        }
+
+        // Libraries built without threading compress within the caller instead
+        ZSTD_CCtx_setParameter(this->m_ctx, ZSTD_c_nbWorkers, workers);
+    }
+
+    ZStdStreamCompressor(const ZStdStreamCompressor&) = delete;
+
+    ~ZStdStreamCompressor() {
+        ZSTD_freeCCtx(this->m_ctx);
+    }
+
+    // Compress against content which the stream likely repeats
+    //  Decompression must reference the same content (like zstd --patch-from)
+    //  The content is not copied, and must outlive the frame
+    void SetPrefix(const BYTE_t* prefix, size_t prefixSize) {
+        auto status = ZSTD_CCtx_refPrefix(this->m_ctx, prefix, prefixSize);
+        if (ZSTD_isError(status))
+            throw std::runtime_error(std::string("failed to set zstd prefix: ") + ZSTD_getErrorName(status));
+    }
+
+    // Compress a chunk, appending any compressed bytes to out
+    void Compress(const BYTE_t* in, size_t inSize, BYTES_t& out) {
+        Stream(in, inSize, out, ZSTD_e_continue);
+    }
+
+    void Compress(const BYTES_t& in, BYTES_t& out) {
+        Compress(in.data(), in.size(), out);
+    }
+
+    // End the frame, appending the remaining compressed bytes to out
+    void Finish(BYTES_t& out) {
+        Stream(nullptr, 0, out, ZSTD_e_end);
+    }
+};
+
 class ZStdDecompressor {
     ZSTD_DCtx* m_ctx;
     ZSTD_DDict* m_dict;
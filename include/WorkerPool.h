@@ -0,0 +1,57 @@
+#pragma once
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <vector>
+#include <string_view>
+
+#include "VUtils.h"
+
+// Fixed set of threads for running short data-parallel jobs
+//  The calling thread takes part in every job, so a pool
+//  without any threads simply runs jobs inline
+class WorkerPool {
+private:
+    std::vector<std::jthread> m_threads;
+
+    std::mutex m_mux;
+    std::condition_variable_any m_wake;
+    std::condition_variable m_done;
+
+    // The job currently being run
+    const std::function<void(size_t)>* m_job = nullptr;
+    size_t m_count = 0;
+    std::atomic_size_t m_next = 0;
+
+    // Threads which have not yet finished the current job
+    size_t m_busy = 0;
+    // Incremented for every job so sleeping threads know to wake
+    uint64_t m_generation = 0;
+
+private:
+    // Claim and run job indices until none remain
+    void Work();
+
+public:
+    WorkerPool() = default;
+    WorkerPool(const WorkerPool&) = delete;
+
+    ~WorkerPool() {
+        Stop();
+    }
+
+    void Start(unsigned int threads, std::string_view name);
+    void Stop();
+
+    // Run job(i) for every i in [0, count)
+    //  Returns once every index has finished
+    //  Jobs must not throw and Run must only be called by one thread
+    void Run(size_t count, const std::function<void(size_t)>& job);
+
+    size_t size() const {
+        return m_threads.size();
+    }
+};
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdio>
+#include <functional>
+
+#include "VUtils.h"
+#include "DataReader.h"
+
+// Append-only log of the world changes made since the last full save
+//  Changes are appended beside the world db in checksummed batches,
+//  so a crash only loses the batch being written.
+//  Each save seals the open segment and starts another, and sealed
+//  segments are removed once the save holding their changes is on disk
+class WorldJournal {
+private:
+    // The world db which the journal follows
+    fs::path m_dbPath;
+
+    FILE* m_file = nullptr;
+    uint32_t m_segment = 0;
+
+private:
+    fs::path SegmentPath(uint32_t segment) const;
+
+    // Get the segments on disk in ascending order
+    std::vector<uint32_t> Segments() const;
+
+public:
+    explicit WorldJournal(fs::path dbPath);
+
+    WorldJournal(const WorldJournal&) = delete;
+
+    ~WorldJournal();
+
+    const fs::path& DBPath() const {
+        return m_dbPath;
+    }
+
+    bool IsOpen() const {
+        return m_file != nullptr;
+    }
+
+    // Pass every intact batch on disk to func in order
+    //  A torn or corrupt batch ends its segment
+    //  Returns the number of batches replayed
+    size_t Replay(const std::function<void(DataReader&)>& func) const;
+
+    // Start a new segment after those on disk
+    //  Throws if it cannot be created
+    void Open();
+
+    // Append a batch and sync it to disk
+    //  Throws on failure
+    void Append(const BYTES_t& batch);
+
+    // Close the open segment and start the next
+    //  If none is open, every segment on disk is considered closed
+    //  Returns the closed segment
+    uint32_t Seal();
+
+    // Remove the segments up to and including segment
+    //  Threadsafe
+    void Discard(uint32_t segment) const;
+};
@@ -6,8 +6,11 @@
 #include "VUtils.h"
 #include "DataReader.h"
 #include "DataWriter.h"
+#include "WorkerPool.h"
+#include "WorldJournal.h"
 
 class IWorldManager;
+struct WorldSnapshot;
 
 class World {
     friend class IWorldManager;
@@ -30,13 +33,14 @@ public:
     void WriteFileMeta(const fs::path& root);
     void WriteFileDB(const fs::path& root);
     void LoadFileDB(const fs::path& root);
-    void CopyCompressDB(const fs::path& root);
-    void WriteFiles(const fs::path& root);
+    // Write the meta and db, backing up the db as it is written
+    //  The db is written on a background thread unless sync
+    void WriteFiles(const fs::path& root, bool sync = false);
 
     void WriteFileMeta();
     void WriteFileDB();
     void LoadFileDB();
-    void WriteFiles();
+    void WriteFiles(bool sync = false);
 };
 
 class IWorldManager {
@@ -44,7 +48,34 @@ private:
     std::unique_ptr<World> m_world;
     //std::jthread m_saveThread;
 
+    // Save running in the background
+    //  Yields the snapshot it wrote, which is released on the main thread
+    std::future<std::unique_ptr<WorldSnapshot>> m_save;
+
+    // Serialize saves in parallel
+    //  Only used by one save at a time
+    WorkerPool m_saveWorkers;
+
+    // Delta backups made since the last full backup
+    //  Negative until a full backup is made this session
+    int m_backupDeltas = -1;
+
+    // Changes made since the last save of the world
+    //  Only kept for the world loaded from the worlds path
+    std::unique_ptr<WorldJournal> m_journal;
+
+private:
+    std::unique_ptr<WorldSnapshot> Snapshot() const;
+
+    // Replay the journal of the loaded world, then start appending to it
+    void OpenJournal(const fs::path& root);
+
+    // Append the changes made since the last batch to the journal
+    void WriteJournal();
+
 public:
+    ~IWorldManager();
+
     World* GetWorld();
 
     // Get root path of worlds
@@ -61,7 +92,15 @@ public:
 
     std::unique_ptr<World> RetrieveWorld(std::string_view name, std::string_view fallbackSeedName) const;
 
-    BYTES_t SaveWorldDB() const;
+    BYTES_t SaveWorldDB();
+
+    // Begin saving the db of the current world to disk
+    //  The world is copied immediately, then written and backed up on a background thread
+    //  Waits for any previous save to finish first
+    void BeginSave(const fs::path& root);
+
+    // Wait for the background save to finish
+    void FinishSave();
     //void LoadFileWorldDB(const fs::path& path) const;
 
     // Create a copy of a world by name
@@ -82,6 +121,8 @@ public:
     void PostZoneInit();
 
     void PostInit();
+    void Update();
+    void Uninit();
 };
 
 // Manager class for everything related to world file loading and file saving
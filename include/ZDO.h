@@ -2,6 +2,7 @@
 
 #include <type_traits>
 #include <algorithm>
+#include <memory>
 
 #include "VUtils.h"
 #include "VUtilsString.h"
@@ -13,6 +14,7 @@
 #include "ValhallaServer.h"
 #include "ZoneManager.h"
 #include "PrefabManager.h"
+#include "InternPool.h"
 
 template<typename T>
 concept TrivialSyncType = 
@@ -28,7 +30,7 @@ concept TrivialSyncType =
 // This class has been refactored numerous times 
 //  Performance is important but memory usage has been highly prioritized here
 // This class used to be 500+ bytes
-//  It is now 120 bytes 
+//  It is now 112 bytes 
 // This class is finally the smallest it could possibly be (I hope so).
 class ZDO {
     friend class IZDOManager;
@@ -64,8 +66,6 @@ private:
     static constexpr uint64_t ENCODED_ORDINAL_MASK =    0b0111111100000000000000000000000000000000000000000000000000000000ULL;
     static constexpr uint64_t ENCODED_OWNER_REV_MASK =  0b0000000011111111111111111111111100000000000000000000000000000000ULL;
 
-    using SHIFTHASH_t = uint64_t;
-
     using Ordinal = uint8_t;
 
     static constexpr Ordinal ORD_FLOAT = 0;
@@ -108,71 +108,145 @@ private:
         return 0b1 << GetOrdinal<T>();
     }
     
-    template<TrivialSyncType T>
-    static constexpr SHIFTHASH_t ToShiftHash(HASH_t hash) {
-        size_t key = ankerl::unordered_dense::hash<Ordinal>{}(GetOrdinal<T>());
-        return static_cast<SHIFTHASH_t>(hash) ^ key;
-    }
+    // Members are ordered by type the same way Save/Serialize writes them:
+    //  F V Q I L S A
+    static constexpr Ordinal ORDINALS_IN_WRITE_ORDER[] = { ORD_FLOAT, ORD_VECTOR3, ORD_QUATERNION, ORD_INT, ORD_LONG, ORD_STRING, ORD_ARRAY };
 
-    template<TrivialSyncType T>
-    static constexpr HASH_t FromShiftHash(SHIFTHASH_t hash) {
-        size_t key = ankerl::unordered_dense::hash<Ordinal>{}(GetOrdinal<T>());
-        return static_cast<HASH_t>(hash ^ key);
+    static constexpr uint8_t GetWriteOrder(Ordinal ordinal) {
+        constexpr uint8_t ORDER[] = { 0, 1, 2, 3, 5, 6, 4 };
+        return ORDER[ordinal];
     }
 
 
 private:
-    class Ord {
-    private:
-        std::variant<std::monostate, float, Vector3f, Quaternion, int32_t, int64_t, std::string, BYTES_t> m_data;
+    using StringEntry = InternPool<std::string>::Entry;
+    using BytesEntry = InternPool<BYTES_t>::Entry;
 
+    // Get a shared reference to a string or byte array value
+    //  Equal values are deduplicated when interning is enabled
+    static const StringEntry* Intern(std::string value);
+    static const BytesEntry* Intern(BYTES_t value);
+
+    static void Release(const StringEntry* entry);
+    static void Release(const BytesEntry* entry);
+
+    // A single typed member
+    //  Strings and byte arrays are held out-of-line in a shared pool to keep every member at 24 bytes
+    class Member {
     public:
-        Ord() {}
+        HASH_t m_key;
+        Ordinal m_ordinal;
 
-        template<TrivialSyncType T>
-        Ord(T type) : m_data(std::move(type)) {}
+    private:
+        union {
+            float m_float;
+            Vector3f m_vec3;
+            Quaternion m_quat;
+            int32_t m_int;
+            int64_t m_long;
+            const StringEntry* m_string;
+            const BytesEntry* m_bytes;
+        };
 
-        Ord(const Ord& other) = default;
-        Ord(Ord&& other) = default;
+        template<TrivialSyncType T>
+        T* _Value() {
+            if constexpr (std::same_as<T, float>) return &m_float;
+            else if constexpr (std::same_as<T, Vector3f>) return &m_vec3;
+            else if constexpr (std::same_as<T, Quaternion>) return &m_quat;
+            else if constexpr (std::same_as<T, int32_t>) return &m_int;
+            else return &m_long;
+        }
 
-        void operator=(const Ord& other) {
-            this->m_data = other.m_data;
+        template<TrivialSyncType T>
+        void _Construct(T value) {
+            if constexpr (std::same_as<T, float>) m_float = value;
+            else if constexpr (std::same_as<T, Vector3f>) std::construct_at(&m_vec3, value);
+            else if constexpr (std::same_as<T, Quaternion>) std::construct_at(&m_quat, value);
+            else if constexpr (std::same_as<T, int32_t>) m_int = value;
+            else if constexpr (std::same_as<T, int64_t>) m_long = value;
+            else if constexpr (std::same_as<T, std::string>) m_string = Intern(std::move(value));
+            else m_bytes = Intern(std::move(value));
         }
 
-        bool HasValue() const {
-            return static_cast<bool>(std::get_if<std::monostate>(&this->m_data));
+        void _CopyFrom(const Member& other) {
+            switch (other.m_ordinal) {
+            case ORD_STRING:    m_string = other.m_string; if (m_string) m_string->AddRef(); break;
+            case ORD_ARRAY:     m_bytes = other.m_bytes; if (m_bytes) m_bytes->AddRef(); break;
+            case ORD_QUATERNION:std::construct_at(&m_quat, other.m_quat); break;
+            case ORD_VECTOR3:   std::construct_at(&m_vec3, other.m_vec3); break;
+            default:            m_long = other.m_long; break; // covers float/int/long
+            }
         }
 
+    public:
         template<TrivialSyncType T>
-        bool IsType() const {
-            return static_cast<bool>(std::get_if<T>(&this->m_data));
+        Member(HASH_t key, T value) : m_key(key), m_ordinal(GetOrdinal<T>()), m_long(0) {
+            _Construct(std::move(value));
         }
 
-        /*
-        // Ensure the underlying type matches
-        //  Will throw on type mismatch
-        template<TrivialSyncType T>
-        void AssertType() const {
-            if (!IsType<T>())
-                throw std::runtime_error("zdo typemask mismatch");
-        }*/
+        Member(const Member& other) : m_key(other.m_key), m_ordinal(other.m_ordinal), m_long(0) {
+            _CopyFrom(other);
+        }
 
-        template<TrivialSyncType T>
-        T* Get() {
-            auto&& data = std::get_if<T>(&this->m_data);
-            if (data) {
-                return data;
+        Member(Member&& other) noexcept : m_key(other.m_key), m_ordinal(other.m_ordinal), m_long(0) {
+            // Steal the out-of-line value
+            if (m_ordinal == ORD_STRING) {
+                m_string = other.m_string;
+                other.m_string = nullptr;
+            }
+            else if (m_ordinal == ORD_ARRAY) {
+                m_bytes = other.m_bytes;
+                other.m_bytes = nullptr;
             }
-            throw std::runtime_error("zdo typemask mismatch");
+            else
+                _CopyFrom(other);
+        }
+
+        ~Member() {
+            if (m_ordinal == ORD_STRING) Release(m_string);
+            else if (m_ordinal == ORD_ARRAY) Release(m_bytes);
+        }
+
+        Member& operator=(const Member& other) {
+            if (this != &other) {
+                Member copy(other);
+                *this = std::move(copy);
+            }
+            return *this;
+        }
+
+        Member& operator=(Member&& other) noexcept {
+            if (this != &other) {
+                std::destroy_at(this);
+                std::construct_at(this, std::move(other));
+            }
+            return *this;
+        }
+
+        // Whether this member sorts before the type/key pair
+        bool Before(Ordinal ordinal, HASH_t key) const {
+            auto a = GetWriteOrder(m_ordinal);
+            auto b = GetWriteOrder(ordinal);
+            return a < b || (a == b && m_key < key);
+        }
+
+        bool Is(Ordinal ordinal, HASH_t key) const {
+            return m_ordinal == ordinal && m_key == key;
         }
 
+        // Get the underlying member value
+        //  Throws on type mismatch
         template<TrivialSyncType T>
         const T* Get() const {
-            auto&& data = std::get_if<T>(&this->m_data);
-            if (data) {
-                return data;
-            }
-            throw std::runtime_error("zdo typemask mismatch");
+            if (m_ordinal != GetOrdinal<T>())
+                throw std::runtime_error("zdo typemask mismatch");
+
+            if constexpr (std::same_as<T, std::string>)
+                return &m_string->Value();
+            else if constexpr (std::same_as<T, BYTES_t>)
+                return &m_bytes->Value();
+            else
+                return const_cast<Member*>(this)->_Value<T>();
         }
 
         // Reassign the underlying member value
@@ -182,58 +256,220 @@ private:
         bool Set(T type) {
             auto&& data = Get<T>();
 
-            // if fairly trivial 
-            //  not BYTES or string because equality operator for them is O(N)
-            if ((!std::is_same_v<T, BYTES_t> && !std::is_same_v<T, std::string>)
-                || *data != type) {
-                *data = std::move(type);
+            if constexpr (std::same_as<T, std::string> || std::same_as<T, BYTES_t>) {
+                // Shared values are immutable, so swap in a reference to the new value
+                if (*data != type) {
+                    if constexpr (std::same_as<T, std::string>) {
+                        auto old = m_string;
+                        m_string = Intern(std::move(type));
+                        Release(old);
+                    }
+                    else {
+                        auto old = m_bytes;
+                        m_bytes = Intern(std::move(type));
+                        Release(old);
+                    }
+                    return true;
+                }
+                return false;
+            }
+            else {
+                // fairly trivial; always reassign
+                *_Value<T>() = std::move(type);
                 return true;
             }
+        }
 
-            return false;
+        // Used when saving or serializing internal ZDO information
+        void Write(DataWriter& writer) const {
+            writer.Write(m_key);
+            switch (m_ordinal) {
+            case ORD_FLOAT:     writer.Write(m_float); break;
+            case ORD_VECTOR3:   writer.Write(m_vec3); break;
+            case ORD_QUATERNION:writer.Write(m_quat); break;
+            case ORD_INT:       writer.Write(m_int); break;
+            case ORD_LONG:      writer.Write(m_long); break;
+            case ORD_STRING:    writer.Write(m_string->View()); break;
+            default:            writer.Write(m_bytes->Value()); break;
+            }
         }
 
-        /*
-        // Get the underlying member
-        //  Will throw on type mismatch
-        template<TrivialSyncType T>
-        T* Get() {
-            AssertType<T>();
+    };
 
-            return _Member<T>();
+    // Flat member storage kept sorted by (type, key)
+    //  The first few members are stored inline, larger ZDOs spill to the heap
+    //  Members loaded from disk may instead stay encoded as their saved record until first used
+    class Members {
+    public:
+        static constexpr uint16_t INLINE_CAPACITY = 2;
+
+    private:
+        uint16_t m_size = 0;
+        uint16_t m_capacity = INLINE_CAPACITY;
+        union {
+            alignas(Member) std::byte m_inline[sizeof(Member) * INLINE_CAPACITY];
+            Member* m_heap;
+            BYTE_VIEW_t m_record;
+        };
+
+        bool _IsInline() const {
+            return m_capacity <= INLINE_CAPACITY;
         }
 
-        // Get the underlying member
-        //  Will throw on type mismatch
-        template<TrivialSyncType T>
-        const T* Get() const {
-            AssertType<T>();
+        // Release any heap allocation and reference a record instead
+        void _AssignRecord(BYTE_VIEW_t record) {
+            clear();
+            if (!_IsInline())
+                ::operator delete(m_heap);
 
-            return _Member<T>();
-        }*/
+            m_capacity = 0;
+            std::construct_at(&m_record, record);
+        }
 
-        // Used when saving or serializing internal ZDO information
-        //  Returns whether write was successful (if type match)
-        //template<TrivialSyncType T>
-        template<TrivialSyncType T>
-        bool Write(DataWriter& writer, SHIFTHASH_t shiftHash) const {
-            auto&& data = std::get_if<T>(&this->m_data);
-            if (data) {
-                writer.Write(FromShiftHash<T>(shiftHash));
-                if constexpr (std::is_same_v<T, std::string>)
-                    writer.Write(std::string_view(*data));
-                else
-                    writer.Write(*data);
-                return true;
+        // Move all members into a larger heap allocation
+        void _Grow(uint16_t capacity) {
+            assert(capacity > m_capacity && capacity > INLINE_CAPACITY);
+
+            auto dst = static_cast<Member*>(::operator new(sizeof(Member) * capacity));
+            auto src = data();
+            for (uint16_t i = 0; i < m_size; i++) {
+                std::construct_at(dst + i, std::move(src[i]));
+                std::destroy_at(src + i);
             }
-            return false;
+
+            if (!_IsInline())
+                ::operator delete(src);
+
+            m_heap = dst;
+            m_capacity = capacity;
         }
 
-        size_t GetTotalAlloc() const {
-            return std::visit(
-                [](const auto& value) -> size_t { if constexpr (VUtils::Traits::is_iterable_v<decltype(value)>) return value.capacity(); else return 0; },
-                this->m_data
-            );
+    public:
+        Members() {}
+
+        Members(const Members& other) {
+            if (other.IsEncoded()) {
+                _AssignRecord(other.m_record);
+                return;
+            }
+
+            Reserve(other.m_size);
+            std::uninitialized_copy(other.begin(), other.end(), data());
+            m_size = other.m_size;
+        }
+
+        Members& operator=(const Members& other) {
+            if (this != &other) {
+                if (other.IsEncoded()) {
+                    _AssignRecord(other.m_record);
+                    return *this;
+                }
+
+                clear();
+                if (IsEncoded())
+                    m_capacity = INLINE_CAPACITY;
+                Reserve(other.m_size);
+                std::uninitialized_copy(other.begin(), other.end(), data());
+                m_size = other.m_size;
+            }
+            return *this;
+        }
+
+        ~Members() {
+            clear();
+            if (!_IsInline())
+                ::operator delete(m_heap);
+        }
+
+        Member* data() { return _IsInline() ? std::launder(reinterpret_cast<Member*>(m_inline)) : m_heap; }
+        const Member* data() const { return const_cast<Members*>(this)->data(); }
+
+        Member* begin() { return data(); }
+        Member* end() { return data() + m_size; }
+        const Member* begin() const { return data(); }
+        const Member* end() const { return data() + m_size; }
+
+        size_t size() const { return m_size; }
+        bool empty() const { return m_size == 0; }
+        size_t capacity() const { return m_capacity; }
+
+        void clear() {
+            std::destroy(begin(), end());
+            m_size = 0;
+        }
+
+        void Reserve(size_t count) {
+            assert(!IsEncoded());
+            if (count > m_capacity) {
+                if (count > std::numeric_limits<uint16_t>::max())
+                    throw std::runtime_error("too many zdo members");
+                _Grow(static_cast<uint16_t>(count));
+            }
+        }
+
+        // Whether the members are still an undecoded saved record
+        bool IsEncoded() const {
+            return m_capacity == 0;
+        }
+
+        // Reference the members section of a saved record
+        //  The bytes are not copied, so must outlive these members (or until decoded)
+        void SetRecord(BYTE_VIEW_t record) {
+            _AssignRecord(record);
+        }
+
+        BYTE_VIEW_t GetRecord() const {
+            assert(IsEncoded());
+            return m_record;
+        }
+
+        // Forget the record so members can be decoded in its place
+        BYTE_VIEW_t TakeRecord() {
+            auto record = GetRecord();
+            m_capacity = INLINE_CAPACITY;
+            return record;
+        }
+
+        // Get the first member not sorting before the type/key pair
+        Member* LowerBound(Ordinal ordinal, HASH_t key) {
+            return std::partition_point(begin(), end(), [&](const Member& member) {
+                return member.Before(ordinal, key);
+            });
+        }
+
+        const Member* Find(Ordinal ordinal, HASH_t key) const {
+            auto&& itr = const_cast<Members*>(this)->LowerBound(ordinal, key);
+            if (itr != end() && itr->Is(ordinal, key))
+                return itr;
+            return nullptr;
+        }
+
+        // Insert a new member at a sorted position
+        template<TrivialSyncType T>
+        Member& Emplace(Member* pos, HASH_t key, T value) {
+            auto index = static_cast<uint16_t>(pos - begin());
+
+            if (m_size == m_capacity) {
+                // Counts are 16 bit, so the last doubling is clamped to fit
+                constexpr size_t MAX_CAPACITY = std::numeric_limits<uint16_t>::max();
+                if (m_capacity == MAX_CAPACITY)
+                    throw std::runtime_error("too many zdo members");
+                Reserve(std::min(static_cast<size_t>(m_capacity) * 2, MAX_CAPACITY));
+            }
+
+            Member* first = begin();
+            if (index == m_size) {
+                std::construct_at(first + index, key, std::move(value));
+            }
+            else {
+                // Shift the tail up by one
+                std::construct_at(first + m_size, std::move(first[m_size - 1]));
+                std::move_backward(first + index, first + m_size - 1, first + m_size);
+                first[index] = Member(key, std::move(value));
+            }
+
+            m_size++;
+            return first[index];
         }
     };
 
@@ -244,44 +480,19 @@ private:
     //  Throws on type mismatch
     template<TrivialSyncType T>
     bool _Set(HASH_t key, T value) {
-        auto mut = ToShiftHash<T>(key);
-
-        // TODO put a null insert up here, then set val or not based on initially present or absent
-        //this->m_members[mut] = Ord(value);
+        constexpr auto ordinal = GetOrdinal<T>();
 
-        //this->m_encoded |= (static_cast<uint64_t>(GetOrdinalMask<T>()) << (8 * 7));
-        //assert(GetOrdinalMask() & GetOrdinalMask<T>());
+        _Decode();
 
-        auto &&insert = this->m_members.insert({ mut, Ord() });
-        if (insert.second) {
-            // Manually initial-set
-            insert.first->second = Ord(std::move(value));
-            this->m_encoded |= (static_cast<uint64_t>(GetOrdinalMask<T>()) << (8 * 7));
+        auto&& pos = this->m_members.LowerBound(ordinal, key);
+        if (pos != m_members.end() && pos->Is(ordinal, key)) {
             assert(GetOrdinalMask() & GetOrdinalMask<T>());
-            return true;
+            return pos->template Set<T>(std::move(value));
         }
-        else {
-            assert(GetOrdinalMask() & GetOrdinalMask<T>());
-            return insert.first->second.Set<T>(std::move(value));
-        }
-        
-        /*
-        // Quickly check whether type is in map
-        if (GetOrdinalMask() & GetOrdinalMask<T>()) {
 
-            // Check whether the exact hash is in map
-            //  If map contains, assumed a value reassignment (of same type)
-            auto&& find = m_members.find(mut);
-            if (find != m_members.end()) {
-                return find->second.Set<T>(value);
-            }
-        }
-        else {
-            this->m_encoded |= (static_cast<uint64_t>(GetOrdinalMask<T>()) << (8 * 7));
-            assert(GetOrdinalMask() & GetOrdinalMask<T>());
-        }
-        bool insert = m_members.insert({ mut, Ord(value) }).second;
-        assert(insert); // It must be uniquely inserted*/
+        this->m_members.Emplace(pos, key, std::move(value));
+        this->m_encoded |= (static_cast<uint64_t>(GetOrdinalMask<T>()) << (8 * 7));
+        assert(GetOrdinalMask() & GetOrdinalMask<T>());
         return true;
     }
 
@@ -306,10 +517,18 @@ private:
     //  UnityEngine Range(1, MAX) covers [1, 2^31 - 1)
 
 private:
-    void Revise() {
-        m_dataRev++;
+    // Increment the data revision and queue the ZDO for syncing
+    void Revise();
+
+    // Decode members still encoded as their saved record
+    //  Decoding is not synchronized, so must only happen on one thread at a time
+    void _Decode() const {
+        if (m_members.IsEncoded())
+            const_cast<ZDO*>(this)->_DecodeRecord();
     }
 
+    void _DecodeRecord();
+
 public:
     uint32_t GetOwnerRevision() const {
         return static_cast<uint32_t>((this->m_encoded >> 32) & 0xFFFFFF);
@@ -324,67 +543,47 @@ private:
         this->m_encoded |= (static_cast<uint64_t>(ownerRev) << 32) & ENCODED_OWNER_REV_MASK;
     }
 
-    void ReviseOwner() {
-        this->m_encoded += 0b0000000000000000000000000000000100000000000000000000000000000000ULL;
-    }
-
-    template<typename T, typename CountType>
-    void _TryWriteType(DataWriter& writer) const {
-        if constexpr (std::is_same_v<CountType, char16_t>)
-            writer.Write((BYTE_t)0); // placeholder byte; iffy for c# char (2 bytes .. encoded to max 3)
+    // Increment the owner revision and queue the ZDO for syncing
+    void ReviseOwner();
 
-        if (GetOrdinalMask() & GetOrdinalMask<T>()) {
-            // Save structure per each type:
-            //  char: count
-            //      string: key
-            //      F V Q I L S A: value
-
-            if constexpr (!std::is_same_v<CountType, char16_t>)
-                writer.Write((BYTE_t)0); // placeholder byte; also 0 byte
-                        
-            const auto size_mark = writer.Position() - sizeof(BYTE_t);
-            CountType count = 0;
-            for (auto&& pair : m_members) {
-                if (pair.second.Write<T>(writer, pair.first))
-                    count++;
-                /*
-                if constexpr (!std::is_same_v<T, std::string>) {
-                    if (pair.second.Write<T>(writer, pair.first))
-                        count++;
+    // Write all members grouped by type in a single pass
+    //  Save writes a count for every type (c# char, up to 3 bytes)
+    //  Serialize writes a byte count and members only for types present in the ordinal mask
+    template<typename CountType>
+        requires std::same_as<CountType, char16_t> || std::same_as<CountType, uint8_t>
+    void _WriteMembers(DataWriter& writer) const {
+        // Save structure per each type:
+        //  char: count
+        //      string: key
+        //      F V Q I L S A: value
+
+        const auto mask = GetOrdinalMask();
+
+        auto&& itr = m_members.begin();
+        for (auto ordinal : ORDINALS_IN_WRITE_ORDER) {
+            auto&& end = std::find_if(itr, m_members.end(), [ordinal](const Member& member) {
+                return member.m_ordinal != ordinal;
+            });
+
+            // Members are grouped by type, so the count is known upfront
+            //  and no longer needs to be backpatched
+            const auto count = static_cast<CountType>(end - itr);
+
+            if constexpr (std::is_same_v<CountType, uint8_t>) {
+                // The receiver expects nothing for types absent from the mask
+                if (!(mask & (0b1 << ordinal))) {
+                    itr = end;
+                    continue;
                 }
-                else {
-                    if (pair.second.Write<std::string_view>(writer, pair.first))
-                        count++;
-                }*/
             }
 
-            if (count) {
-                auto end_mark = writer.Position();
-                writer.SetPos(size_mark);
-
-                if constexpr (std::is_same_v<CountType, char16_t>) {
-                    auto&& vec = std::get<std::reference_wrapper<BYTES_t>>(writer.m_data).get();
-                    auto extraCount = VUtils::String::GetUTF8ByteCount(count) - 1;
-                    if (extraCount) {
-                        assert(count >= 0x80);
-                        // make room for utf8 bytes
-                        vec.insert(vec.begin() + size_mark, extraCount, 0);
-                        writer.Write((char16_t)count);
-                        end_mark += extraCount;
-                    } else {
-                        assert(count < 0x80);
-                        writer.Write((BYTE_t)count); // basic write in place
-                    }
-                }
-                else {
-                    writer.Write(count);
-                }
+            writer.Write(count);
 
-                writer.SetPos(end_mark);
-
-
-            }
+            for (; itr != end; ++itr)
+                itr->Write(writer);
         }
+
+        assert(itr == m_members.end());
     }
 
     template<typename T, typename CountType>
@@ -393,6 +592,8 @@ private:
         //CountType count = sizeof(CountType) == 2 ? reader.ReadChar() : reader.Read<BYTE_t>();
         decltype(auto) count = reader.Read<CountType>();
 
+        m_members.Reserve(m_members.size() + count);
+
         for (int i=0; i < count; i++) {
             // ...fuck
             // https://stackoverflow.com/questions/2934904/order-of-evaluation-in-c-function-parameters
@@ -404,8 +605,8 @@ private:
 
 
 
-// 120 bytes:
-private:    UNORDERED_MAP_t<SHIFTHASH_t, Ord> m_members;    // 64 bytes (excluding internal alloc)
+// 112 bytes:
+private:    mutable Members m_members;                      // 56 bytes (2 inline members, or a saved record)
 private:    Quaternion m_rotation;                          // 16 bytes
 private:    Vector3f m_pos;                                 // 12 bytes
 public:     uint32_t m_dataRev {};                          // 4 bytes (PADDING)
@@ -436,24 +637,8 @@ private:
     }
 
     // Set the owner without revising
-    void _SetOwner(OWNER_t owner) {
-        if (!(owner >= -2147483647LL && owner <= 4294967293LL)) {
-            // Ensure filler complement bits are all the same (full negative or full positive)
-            //if ((owner < 0 && (static_cast<uint64_t>(owner) & ~ENCODED_OWNER_MASK) != ~ENCODED_OWNER_MASK)
-                //|| (owner >= 0 && (static_cast<uint64_t>(owner) & ~ENCODED_OWNER_MASK) == ~ENCODED_OWNER_MASK))
-            throw std::runtime_error("OWNER_t unexpected encoding (client Utils.GenerateUID() differs?)");
-        }
-
-        // Zero out the owner bytes (including sign)
-        this->m_encoded &= ~ENCODED_OWNER_MASK;
-        assert(Owner() == 0);
-
-        // Set the owner bytes
-        //  ignore the 2's complement middle bytes
-        this->m_encoded |= (static_cast<uint64_t>(owner) & ENCODED_OWNER_MASK);
-
-        assert(Owner() == owner);
-    }
+    //  Also keeps the owner index of the ZDOManager up to date
+    void _SetOwner(OWNER_t owner);
 
 public:
     ZDO();
@@ -473,8 +658,10 @@ public:
     void Save(DataWriter& writer) const;
 
     // Load ZDO from disk
+    //  Lazy loads keep members encoded until first used, referencing
+    //  the reader's bytes, which must then outlive the ZDO
     //  Returns whether this ZDO is modern
-    bool Load(DataReader& reader, int32_t version);
+    bool Load(DataReader& reader, int32_t version, bool lazy = false);
 
 
 
@@ -483,12 +670,11 @@ public:
     //  Throws on type mismatch
     template<TrivialSyncType T>
     const T* Get(HASH_t key) const {
+        _Decode();
+
         if (GetOrdinalMask() & GetOrdinalMask<T>()) {
-            auto mut = ToShiftHash<T>(key);
-            auto&& find = m_members.find(mut);
-            if (find != m_members.end()) {
-                return find->second.Get<T>();
-            }
+            if (auto member = m_members.Find(GetOrdinal<T>(), key))
+                return member->template Get<T>();
         }
         return nullptr;
     }
@@ -676,8 +862,9 @@ public:
 
 
     size_t GetTotalAlloc() {
-        size_t size = 0;
-        for (auto&& pair : m_members) size += sizeof(Ord) + pair.second.GetTotalAlloc();
+        size_t size = m_members.capacity() > Members::INLINE_CAPACITY 
+            ? m_members.capacity() * sizeof(Member) : 0;
+        // String and byte values are shared, and accounted for by the ZDOManager
         return size;
     }
 
@@ -1,21 +1,32 @@
 #pragma once
 
 #include <vector>
+#include <array>
 #include <functional>
+#include <type_traits>
+#include <mutex>
 
 #include "Vector.h"
 #include "ZDO.h"
 #include "Peer.h"
 #include "PrefabManager.h"
 #include "ZoneManager.h"
+#include "SlabPool.h"
+#include "WorkerPool.h"
+#include "TombstoneSet.h"
+#include "MappedFile.h"
+#include "ZoneStore.h"
 
 class IZDOManager {
 	friend class INetManager;
 	friend class IValhalla;
 	friend class ZDO;
+	friend class WorldTool;
 		
 	//static constexpr int WIDTH_IN_ZONES = 512; // The width of world in zones (the actual world is smaller than this at 315)
 	static constexpr int MAX_DEAD_OBJECTS = 100000;
+	// Seconds a destroyed ZDO is remembered for
+	static constexpr float DEAD_OBJECT_LIFETIME = 60 * 60;
 
 	static bool PREFAB_CHECK_FUNCTION(const ZDO& zdo, HASH_t prefabHash, Prefab::Flag flagsPresent, Prefab::Flag flagsAbsent) {
 		auto&& prefab = zdo.GetPrefab();
@@ -29,23 +40,147 @@ private:
 	// Increments over the course of the game as ZDOs are created
 	uint32_t m_nextUid = 1;
 
+	// Shared string and byte array member values
+	//	Declared before the ZDO pool so ZDOs are freed first
+	InternPool<std::string> m_strings;
+	InternPool<BYTES_t> m_bytes;
+
+	// The loaded world db, which still holds the members of untouched ZDOs
+	//	Declared before the ZDO pool so it outlives them
+	std::unique_ptr<MappedFile> m_source;
+
+	// Guards the intern pools while ZDOs are loaded in parallel
+	std::mutex m_internMux;
+	bool m_parallelLoad = false;
+
 	// Responsible for managing ZDOs lifetimes
-	UNORDERED_MAP_t<ZDOID, std::unique_ptr<ZDO>> m_objectsByID;
+	//	ZDOs are allocated in chunks rather than individually
+	SlabPool<ZDO> m_pool;
+
+	// Contains ZDOs according to ID
+	UNORDERED_MAP_t<ZDOID, ZDO*> m_objectsByID;
+
+	// Contiguous storage of the ZDOs within a single zone
+	//	Positions are mirrored alongside so radius queries can
+	//	stream over a packed array without dereferencing each ZDO
+	struct Sector {
+		std::vector<ZDO*> m_zdos;
+		std::vector<Vector3f> m_positions;
+
+		// ZDOs within this zone by prefab
+		//	Prefab queries only touch matching ZDOs instead of the whole zone
+		UNORDERED_MAP_t<HASH_t, std::vector<ZDO*>> m_zdosByPrefab;
+
+		// Flags commonly queried on their own
+		static constexpr std::array<Prefab::Flag, 3> BUCKETED_FLAGS = {
+			Prefab::Flag::DISTANT,
+			Prefab::Flag::PLAYER,
+			Prefab::Flag::SESSIONED
+		};
+
+		// ZDOs within this zone having each bucketed flag
+		std::array<std::vector<ZDO*>, BUCKETED_FLAGS.size()> m_zdosByFlag;
+
+		// Whether a bucket covers any of the flags
+		static constexpr bool IsBucketed(Prefab::Flag flags) {
+			for (auto&& flag : BUCKETED_FLAGS) {
+				if ((flags & flag) != Prefab::Flag::NONE)
+					return true;
+			}
+			return false;
+		}
+
+		// Get the smallest bucket of ZDOs having one of the flags
+		//	Returns null if none of the flags are bucketed
+		const std::vector<ZDO*>* GetFlagBucket(Prefab::Flag flags) const {
+			const std::vector<ZDO*>* out = nullptr;
+			for (size_t i = 0; i < BUCKETED_FLAGS.size(); i++) {
+				if ((flags & BUCKETED_FLAGS[i]) != Prefab::Flag::NONE
+					&& (!out || m_zdosByFlag[i].size() < out->size()))
+					out = &m_zdosByFlag[i];
+			}
+			return out;
+		}
+
+		// Sequence of the latest change within this zone
+		uint64_t m_seq = 0;
+		// Recently changed ZDOs by ascending change sequence
+		std::vector<std::pair<uint64_t, ZDOID>> m_journal;
+		// Changes up to this sequence have been trimmed from the journal
+		uint64_t m_journalFloor = 0;
+
+		void Insert(ZDO& zdo);
+		// Swap-removes a ZDO
+		//	Returns whether the ZDO was present
+		bool Erase(ZDO& zdo);
+		size_t size() const { return m_zdos.size(); }
+		bool empty() const { return m_zdos.empty(); }
+	};
 
 	// Contains ZDOs according to Zone
-	std::array<UNORDERED_SET_t<ZDO*>,
-		(IZoneManager::WORLD_RADIUS_IN_ZONES * IZoneManager::WORLD_RADIUS_IN_ZONES * 2 * 2)> m_objectsBySector; // takes up around 5MB; could be around 72 bytes with map
+	//	Only zones which have held ZDOs are allocated (keyed by SectorToIndex)
+	UNORDERED_MAP_t<int, Sector> m_objectsBySector;
 
 	// Contains ZDOs according to prefab
 	UNORDERED_MAP_t<HASH_t, UNORDERED_SET_t<ZDO*>> m_objectsByPrefab;
 
+	// Contains ZDOs according to owner
+	//	Unowned ZDOs are only included if sessioned (to be cleaned up)
+	UNORDERED_MAP_t<OWNER_t, UNORDERED_SET_t<ZDO*>> m_objectsByOwner;
+
 	// Primarily used in RPC_ZDOData
-	//robin_hood::unordered_map<ZDOID, TICKS_t> m_erasedZDOs;
-	UNORDERED_SET_t<ZDOID> m_erasedZDOs;
+	//	Prevents lagging clients from resurrecting recently destroyed ZDOs
+	TombstoneSet<ZDOID> m_erasedZDOs{ MAX_DEAD_OBJECTS, DEAD_OBJECT_LIFETIME };
 
 	// Contains recently destroyed ZDOs to be sent
 	std::vector<ZDOID> m_destroySendList;
 
+	// ZDOs modified since they were last journaled
+	UNORDERED_SET_t<ZDOID> m_dirtyZDOs;
+
+	// Global change sequence; incremented for every journaled change
+	uint64_t m_changeSeq = 0;
+
+	// Persistent ZDOs changed or destroyed since last written to the world journal
+	//	Only tracked once the journal is open
+	UNORDERED_SET_t<ZDOID> m_unsavedZDOs;
+	std::vector<ZDOID> m_unsavedDestroys;
+	bool m_trackChanges = false;
+
+	// Zones evicted from memory while no peer is near
+	//	Only used once paging is started
+	std::unique_ptr<ZoneStore> m_pages;
+
+	// Time each resident zone was last near a peer
+	UNORDERED_MAP_t<ZoneID, float> m_zonesLastNeeded;
+
+	// Paged out zones which ZDOs have since entered
+	UNORDERED_SET_t<ZoneID> m_pagesWanted;
+
+	// A serialized network form of a ZDO
+	struct Payload {
+		uint32_t m_dataRev;
+		uint32_t m_ownerRev;
+		float m_lastUsed;
+		BYTES_t m_bytes;
+	};
+
+	// Recently sent ZDO payloads shared between all peers
+	UNORDERED_MAP_t<ZDOID, Payload> m_payloads;
+
+	// ZDOs chosen to be sent to a peer
+	struct SyncPlan {
+		Peer* m_peer;
+		size_t m_availableSpace;
+		std::vector<std::reference_wrapper<ZDO>> m_syncList;
+	};
+
+	// Reused between sends
+	std::vector<SyncPlan> m_syncPlans;
+
+	// Threads which build the sync plans of peers
+	WorkerPool m_syncWorkers;
+
 	BYTES_t m_temp;
 
 	//static const std::function<bool(const ZDO&, HASH_t, Prefab::FLAG_t, Prefab::FLAG_t)> PREFAB_FUNCTION;
@@ -63,19 +198,79 @@ private:
 	// Relay a ZDO sector change to clients (internal)
 	void InvalidateZDOZone(ZDO& zdo);
 
-	void AssignOrReleaseZDOs(Peer& peer);
+	// Insert a ZDO into the index of its owner (internal)
+	void AddZDOToOwner(ZDO& zdo);
+	// Remove a ZDO from the index of an owner (internal)
+	void RemoveFromOwner(ZDO& zdo, OWNER_t owner);
+	// Move a ZDO between owner indexes after its owner changed (internal)
+	//	ZDOs which are not managed (such as temporary copies) are ignored
+	void ReindexOwner(ZDO& zdo, OWNER_t previous);
+
+	// Lock the intern pools if they are in use by several threads
+	std::unique_lock<std::mutex> LockInternPools();
+
+	// Whether a peer takes part in ZDO ownership assignment
+	bool CanAssignZDOs(Peer& peer);
+	// Assign or release ownership of ZDOs around peers
+	//	Every zone near a peer is visited once, regardless of how many peers are near
+	void AssignOrReleaseZDOs(const std::vector<Peer*>& peers);
 	//void SmartAssignZDOs();
 
 	decltype(m_objectsByID)::iterator DestroyZDO(decltype(m_objectsByID)::iterator itr);
 
+	// Remove a ZDO from memory without destroying it
+	//	Does not check whether the iterator is at end of container
+	decltype(m_objectsByID)::iterator UnloadZDO(decltype(m_objectsByID)::iterator itr);
+
 	// Performs an unchecked erasure
 	//	Does not check whether the iterator is at end of container
 	decltype(m_objectsByID)::iterator EraseZDO(decltype(m_objectsByID)::iterator itr);
 	void EraseZDO(ZDOID uid);
 	void SendAllZDOs(Peer& peer);
 	bool SendZDOs(Peer& peer, bool flush);
-	std::list<std::pair<std::reference_wrapper<ZDO>, float>> CreateSyncList(Peer& peer);
-
+	// Send outdated ZDOs to every peer
+	//	Sync lists are built in parallel, then sent in order
+	void SendZDOs(const std::vector<Peer*>& peers);
+	// Get the number of bytes which can be sent to a peer
+	//	Returns 0 if the peer is too congested
+	size_t GetSyncCapacity(Peer& peer, bool flush);
+	// Send a ZDOData packet containing the sync list
+	//	Returns whether anything was sent
+	bool SendSyncList(Peer& peer, const std::vector<std::reference_wrapper<ZDO>>& syncList, size_t availableSpace);
+
+	// Queue a modified ZDO to be checked against nearby peers (internal)
+	void MarkDirty(const ZDO& zdo) {
+		m_dirtyZDOs.insert(zdo.ID());
+	}
+	// Record modified ZDOs into the journal of their zone
+	void FlushDirtyZDOs();
+	// Add ZDOs changed within a zone since the peers watermark to its sync queue
+	//	Zones that have not changed since are skipped entirely
+	void PullZoneChanges(Peer& peer, ZoneID zone, bool near);
+	// Select up to max of the highest priority outdated ZDOs for a peer
+	//	Only mutates the sync state of the peer, so peers can be planned concurrently
+	std::vector<std::reference_wrapper<ZDO>> CreateSyncList(Peer& peer, size_t max);
+
+	// Get the serialized network form of a ZDO
+	//	The ZDO is only serialized again if it has been revised since
+	const BYTES_t& GetPayload(const ZDO& zdo);
+
+	// Add a ZDO read from disk to every index
+	void AddLoadedZDO(ZDO& zdo);
+
+	// Whether a ZDO can be evicted along with its zone
+	bool CanPageOut(const ZDO& zdo) const;
+	// Write the evictable ZDOs of a zone to the paging file and unload them
+	void PageOutZone(ZoneID zone);
+	// Load the ZDOs of a zone back from the paging file
+	//	ZDOs which are already resident are kept instead
+	void PageInZone(ZoneID zone);
+	// Page in zones near peers and page out zones no peer has been near for a while
+	void UpdatePaging(const std::vector<Peer*>& peers);
+	// Page in zones which ZDOs have entered since they were paged out
+	void PageInWanted();
+
+	// Create a ZDO which is not yet within any index
 	ZDO& Instantiate(Vector3f position);
 	ZDO& Instantiate(ZDOID uid, Vector3f position);
 		
@@ -87,15 +282,102 @@ private:
 	// Performs a coordinate to pitch conversion
 	int SectorToIndex(ZoneID zone) const;
 
+	// Get the sector of a zone
+	//	Returns null if the zone is out of bounds or has never held ZDOs
+	Sector* GetSector(ZoneID zone);
+
+	// Invoke a visitor on a ZDO
+	//	Returns false if the visitor asked to stop
+	template<typename F>
+	static bool VisitZDO(F& func, ZDO& zdo) {
+		if constexpr (std::is_void_v<std::invoke_result_t<F&, ZDO&>>) {
+			func(zdo);
+			return true;
+		}
+		else {
+			return func(zdo);
+		}
+	}
+
+	// Collect up to max ZDOs visited by a query
+	template<typename Query>
+	static std::list<std::reference_wrapper<ZDO>> CollectZDOs(size_t max, Query&& query) {
+		std::list<std::reference_wrapper<ZDO>> out;
+		if (max) {
+			query([&](ZDO& zdo) {
+				out.push_back(zdo);
+				return --max != 0;
+			});
+		}
+		return out;
+	}
+
+	// Get the nearest ZDO within a radius matching a predicate
+	template<typename F>
+	ZDO* FindNearestZDO(Vector3f pos, float radius, F&& pred) {
+		ZDO* out = nullptr;
+		float minSqDist = std::numeric_limits<float>::max();
+
+		ForEachZDO(pos, radius, [&](ZDO& zdo, float sqDist) {
+			if (sqDist < minSqDist && pred(zdo)) {
+				out = &zdo;
+				minSqDist = sqDist;
+			}
+		});
+
+		return out;
+	}
+
+public:
+	// Weak reference to a ZDO which becomes invalid once the ZDO is destroyed
+	using Handle = SlabPool<ZDO>::Handle;
+
+	// Copy of the persistent ZDOs which can be saved off the main thread
+	//	Copies share string and byte array values with the live ZDOs,
+	//	so must be created and destroyed on the main thread
+	struct SaveSnapshot {
+		uint32_t m_nextUid;
+		std::vector<ZDO> m_zdos;
+
+		// Zones which are paged out are read from the paging file
+		//	The pin keeps their offsets valid until the snapshot is gone
+		fs::path m_pagePath;
+		std::vector<ZoneStore::Chunk> m_pages;
+		std::shared_ptr<bool> m_pagePin;
+		size_t m_pagedCount = 0;
+	};
+
 public:
 	void Init();
 	void Update();
 
-	// Used when saving the world from disk
-	void Save(DataWriter& writer);
+	// Copy the persistent ZDOs for saving
+	SaveSnapshot Snapshot();
+
+	// Used when saving the world to disk
+	//	ZDOs are serialized in shards across the workers, and the bytes
+	//	are passed to sink in order, so the output matches a serial save
+	//	Threadsafe, but the workers must not be used elsewhere meanwhile
+	static void Save(WorkerPool& workers, const SaveSnapshot& snapshot, const std::function<void(const BYTES_t&)>& sink);
 
 	// Used when loading the world from disk
-	void Load(DataReader& reader, int version);
+	//	If the mapping being read is handed over, ZDO members are
+	//	only decoded once used and are otherwise saved unchanged
+	void Load(DataReader& reader, int version, std::unique_ptr<MappedFile> source = nullptr);
+
+	// Start recording changes to persistent ZDOs for the world journal
+	void TrackChanges();
+
+	// Write persistent ZDOs changed or destroyed since the last call
+	void SaveChanges(DataWriter& writer);
+
+	// Apply changes written by SaveChanges on top of the loaded world
+	void LoadChanges(DataReader& reader, int version);
+
+	// Start evicting zones which no peer has been near for a while
+	//	Evicted zones are kept in a paging file at path until needed again
+	//	Throws if the paging file cannot be created
+	void StartPaging(fs::path path);
 
 	ZDO& Instantiate(const Prefab& prefab, Vector3f pos, Quaternion rot);
 	ZDO& Instantiate(const Prefab& prefab, Vector3f pos) { return Instantiate(prefab, pos, Quaternion::IDENTITY); }
@@ -109,6 +391,148 @@ public:
 	// Get a ZDO by id
 	//	TODO use optional<reference>
 	ZDO* GetZDO(ZDOID id);
+	// Get a ZDO by handle
+	//	Returns null if the ZDO has since been destroyed
+	ZDO* GetZDO(Handle handle) {
+		return m_pool.Get(handle);
+	}
+	// Get a handle which safely outlives the ZDO
+	//	The ZDO must be managed, such as one from GetZDO
+	Handle GetHandle(const ZDO& zdo) const {
+		return m_pool.GetHandle(&zdo);
+	}
+	// Get a handle to any ZDO
+	//	Returns an invalid handle if the ZDO is not managed (such as a temporary copy)
+	Handle FindHandle(const ZDO& zdo) const {
+		return m_pool.FindHandle(&zdo);
+	}
+
+	// Visit every ZDO within a zone
+	//	Visitors may return false to stop early, in which case false is returned
+	//	Visitors must not create, destroy or move ZDOs
+	template<typename F>
+	bool ForEachZDO(ZoneID zone, F&& func) {
+		if (auto sector = GetSector(zone)) {
+			for (auto zdo : sector->m_zdos) {
+				if (!VisitZDO(func, *zdo))
+					return false;
+			}
+		}
+		return true;
+	}
+	// Visit every ZDO within zones up to a zone radius away
+	template<typename F>
+	bool ForEachZDO_Zones(ZoneID zone, int radius, F&& func) {
+		for (auto z = zone.y - radius; z <= zone.y + radius; z++) {
+			for (auto x = zone.x - radius; x <= zone.x + radius; x++) {
+				if (!ForEachZDO(ZoneID(x, z), func))
+					return false;
+			}
+		}
+		return true;
+	}
+	// Visit every ZDO within a radius
+	//	Visitors may also take the squared distance of the ZDO as a second argument
+	template<typename F>
+	bool ForEachZDO(Vector3f pos, float radius, F&& func) {
+		const float sqRadius = radius * radius;
+
+		auto minZone = IZoneManager::WorldToZonePos(Vector3f(pos.x - radius, 0, pos.z - radius));
+		auto maxZone = IZoneManager::WorldToZonePos(Vector3f(pos.x + radius, 0, pos.z + radius));
+
+		for (auto z = minZone.y; z <= maxZone.y; z++) {
+			for (auto x = minZone.x; x <= maxZone.x; x++) {
+				auto sector = GetSector({ x, z });
+				if (!sector)
+					continue;
+
+				auto&& positions = sector->m_positions;
+				for (size_t i = 0; i < positions.size(); i++) {
+					const float sqDist = positions[i].SqDistance(pos);
+					if (sqDist > sqRadius)
+						continue;
+
+					auto&& zdo = *sector->m_zdos[i];
+					if constexpr (std::is_invocable_v<F&, ZDO&, float>) {
+						if constexpr (std::is_void_v<std::invoke_result_t<F&, ZDO&, float>>)
+							func(zdo, sqDist);
+						else if (!func(zdo, sqDist))
+							return false;
+					}
+					else if (!VisitZDO(func, zdo))
+						return false;
+				}
+			}
+		}
+		return true;
+	}
+
+	// Visit every ZDO within a zone with prefab and/or flag
+	//	Only ZDOs of the prefab (or else of a bucketed flag) are checked
+	template<typename F>
+	bool ForEachZDO(ZoneID zone, HASH_t prefab, Prefab::Flag flagsPresent, Prefab::Flag flagsAbsent, F&& func) {
+		auto&& visit = [&](ZDO& zdo) {
+			return !PREFAB_CHECK_FUNCTION(zdo, prefab, flagsPresent, flagsAbsent) || VisitZDO(func, zdo);
+		};
+
+		auto sector = GetSector(zone);
+		if (!sector)
+			return true;
+
+		const std::vector<ZDO*>* zdos = &sector->m_zdos;
+		if (prefab) {
+			auto&& find = sector->m_zdosByPrefab.find(prefab);
+			if (find == sector->m_zdosByPrefab.end())
+				return true;
+			zdos = &find->second;
+		}
+		else if (auto bucket = sector->GetFlagBucket(flagsPresent)) {
+			zdos = bucket;
+		}
+
+		for (auto zdo : *zdos) {
+			if (!visit(*zdo))
+				return false;
+		}
+		return true;
+	}
+	// Visit every ZDO within a radius with prefab and/or flag
+	//	Only ZDOs of the prefab are checked if a prefab is given
+	template<typename F>
+	bool ForEachZDO(Vector3f pos, float radius, HASH_t prefab, Prefab::Flag flagsPresent, Prefab::Flag flagsAbsent, F&& func) {
+		if (!prefab && !Sector::IsBucketed(flagsPresent)) {
+			return ForEachZDO(pos, radius, [&](ZDO& zdo) {
+				return !PREFAB_CHECK_FUNCTION(zdo, prefab, flagsPresent, flagsAbsent) || VisitZDO(func, zdo);
+			});
+		}
+
+		const float sqRadius = radius * radius;
+
+		auto minZone = IZoneManager::WorldToZonePos(Vector3f(pos.x - radius, 0, pos.z - radius));
+		auto maxZone = IZoneManager::WorldToZonePos(Vector3f(pos.x + radius, 0, pos.z + radius));
+
+		for (auto z = minZone.y; z <= maxZone.y; z++) {
+			for (auto x = minZone.x; x <= maxZone.x; x++) {
+				bool next = ForEachZDO(ZoneID(x, z), prefab, flagsPresent, flagsAbsent, [&](ZDO& zdo) {
+					return zdo.Position().SqDistance(pos) > sqRadius || VisitZDO(func, zdo);
+				});
+
+				if (!next)
+					return false;
+			}
+		}
+		return true;
+	}
+
+	// Get the number of ZDOs of a prefab within a zone
+	size_t CountZDOs(ZoneID zone, HASH_t prefab) {
+		if (auto sector = GetSector(zone)) {
+			auto&& find = sector->m_zdosByPrefab.find(prefab);
+			if (find != sector->m_zdosByPrefab.end())
+				return find->second.size();
+		}
+		return 0;
+	}
 
 	// Get all ZDOs strictly within a zone
 	void GetZDOs_Zone(ZoneID zone, std::list<std::reference_wrapper<ZDO>>& out);
@@ -131,11 +555,9 @@ public:
 	// Get a capped number of ZDOs with prefab and/or flag
 	//	*Note: Prefab or Flag must be non-zero for anything to be returned
 	std::list<std::reference_wrapper<ZDO>> SomeZDOs(Vector3f pos, float radius, size_t max, HASH_t prefab, Prefab::Flag flagsPresent, Prefab::Flag flagsAbsent) {
-		return SomeZDOs(pos, radius, max, 
-			[&](const ZDO& zdo) {
-				return PREFAB_CHECK_FUNCTION(zdo, prefab, flagsPresent, flagsAbsent);
-			}
-		);
+		return CollectZDOs(max, [&](auto&& visit) {
+			ForEachZDO(pos, radius, prefab, flagsPresent, flagsAbsent, visit);
+		});
 	}
 
 
@@ -148,14 +570,17 @@ public:
 	// Get a capped number of ZDOs within a radius in zone with prefab and/or flag
 	std::list<std::reference_wrapper<ZDO>> SomeZDOs(ZoneID zone, size_t max, Vector3f pos, float radius, HASH_t prefab, Prefab::Flag flagsPresent, Prefab::Flag flagsAbsent) {
 		const auto sqRadius = radius * radius;
-		return SomeZDOs(zone, max, [&](const ZDO& zdo) {
-			return zdo.Position().SqDistance(pos) <= sqRadius
-				&& PREFAB_CHECK_FUNCTION(zdo, prefab, flagsPresent, flagsAbsent);
+		return CollectZDOs(max, [&](auto&& visit) {
+			ForEachZDO(zone, prefab, flagsPresent, flagsAbsent, [&](ZDO& zdo) {
+				return zdo.Position().SqDistance(pos) > sqRadius || visit(zdo);
+			});
 		});
 	}
 	// Get a capped number of ZDOs within a zone with prefab and/or flag
 	std::list<std::reference_wrapper<ZDO>> SomeZDOs(ZoneID zone, size_t max, HASH_t prefab, Prefab::Flag flagsPresent, Prefab::Flag flagsAbsent) {
-		return SomeZDOs(zone, max, Vector3f::Zero(), std::numeric_limits<float>::max(), prefab, flagsPresent, flagsAbsent);
+		return CollectZDOs(max, [&](auto&& visit) {
+			ForEachZDO(zone, prefab, flagsPresent, flagsAbsent, visit);
+		});
 	}
 	// Get a capped number of ZDOs within a zone with prefab and/or flag
 	std::list<std::reference_wrapper<ZDO>> SomeZDOs(ZoneID zone, size_t max, Vector3f pos, float radius) {
@@ -191,17 +616,11 @@ public:
 	}
 	// Get all ZDOs within a zone of prefab and/or flag
 	std::list<std::reference_wrapper<ZDO>> GetZDOs(ZoneID zone, HASH_t prefab, Prefab::Flag flagsPresent, Prefab::Flag flagsAbsent) {
-		return SomeZDOs(zone, -1, [&](const ZDO& zdo) {
-			return PREFAB_CHECK_FUNCTION(zdo, prefab, flagsPresent, flagsAbsent);
-		});
+		return SomeZDOs(zone, -1, prefab, flagsPresent, flagsAbsent);
 	}
 	// Get all ZDOs within a radius in zone
 	std::list<std::reference_wrapper<ZDO>> GetZDOs(ZoneID zone, Vector3f pos, float radius, HASH_t prefab, Prefab::Flag flagsPresent, Prefab::Flag flagsAbsent) {
-		const auto sqRadius = radius * radius;
-		return SomeZDOs(zone, -1, [&](const ZDO& zdo) {
-			return zdo.Position().SqDistance(pos) <= sqRadius
-				&& PREFAB_CHECK_FUNCTION(zdo, prefab, flagsPresent, flagsAbsent);
-		});
+		return SomeZDOs(zone, -1, pos, radius, prefab, flagsPresent, flagsAbsent);
 	}
 	// Get all ZDOs within a radius in zone
 	std::list<std::reference_wrapper<ZDO>> GetZDOs(ZoneID zone, Vector3f pos, float radius) {
@@ -211,17 +630,21 @@ public:
 
 	// Get any ZDO within a radius with prefab and/or flag
 	ZDO* AnyZDO(Vector3f pos, float radius, HASH_t prefabHash, Prefab::Flag flagsPresent, Prefab::Flag flagsAbsent) {
-		auto&& zdos = SomeZDOs(pos, radius, 1, prefabHash, flagsPresent, flagsAbsent);
-		if (zdos.empty())
-			return nullptr;
-		return &zdos.front().get();
+		ZDO* out = nullptr;
+		ForEachZDO(pos, radius, prefabHash, flagsPresent, flagsAbsent, [&](ZDO& zdo) {
+			out = &zdo;
+			return false;
+		});
+		return out;
 	}
 	// Get any ZDO within a zone with prefab and/or flag
 	ZDO* AnyZDO(ZoneID zone, HASH_t prefabHash, Prefab::Flag flagsPresent, Prefab::Flag flagsAbsent) {
-		auto&& zdos = SomeZDOs(zone, 1, prefabHash, flagsPresent, flagsAbsent);
-		if (zdos.empty())
-			return nullptr;
-		return &zdos.front().get();
+		ZDO* out = nullptr;
+		ForEachZDO(zone, prefabHash, flagsPresent, flagsAbsent, [&](ZDO& zdo) {
+			out = &zdo;
+			return false;
+		});
+		return out;
 	}
 
 
@@ -229,9 +652,24 @@ public:
 	ZDO* NearestZDO(Vector3f pos, float radius, const std::function<bool(const ZDO&)>& pred);
 	// Get the nearest ZDO within a radius with prefab and/or flag
 	ZDO* NearestZDO(Vector3f pos, float radius, HASH_t prefabHash, Prefab::Flag flagsPresent, Prefab::Flag flagsAbsent) {
-		return NearestZDO(pos, radius, [&](const ZDO& zdo) {
-			return PREFAB_CHECK_FUNCTION(zdo, prefabHash, flagsPresent, flagsAbsent);
+		if (!prefabHash) {
+			return FindNearestZDO(pos, radius, [&](const ZDO& zdo) {
+				return PREFAB_CHECK_FUNCTION(zdo, prefabHash, flagsPresent, flagsAbsent);
+			});
+		}
+
+		ZDO* out = nullptr;
+		float minSqDist = std::numeric_limits<float>::max();
+
+		ForEachZDO(pos, radius, prefabHash, flagsPresent, flagsAbsent, [&](ZDO& zdo) {
+			const float sqDist = zdo.Position().SqDistance(pos);
+			if (sqDist < minSqDist) {
+				out = &zdo;
+				minSqDist = sqDist;
+			}
 		});
+
+		return out;
 	}
 
 
@@ -150,6 +150,15 @@ private:
 	// Game-state global keys
 	UNORDERED_SET_t<std::string, ankerl::unordered_dense::string_hash, std::equal_to<>> m_globalKeys;
 
+	// Zones generated since last written to the world journal
+	//	Only tracked once the journal is open
+	std::vector<ZoneID> m_unsavedZones;
+	bool m_trackChanges = false;
+
+	// Global keys as last written to the world journal
+	//	Keys can be modified from anywhere, so they are compared rather than tracked
+	decltype(m_globalKeys) m_savedGlobalKeys;
+
 private:
 	void SendGlobalKeys();
 	void SendGlobalKeys(Peer& peer);
@@ -203,6 +212,15 @@ public:
 	void Save(DataWriter& pkg);
 	void Load(DataReader& reader, int32_t version);
 
+	// Start recording generated zones and global keys for the world journal
+	void TrackChanges();
+
+	// Write zones generated and global keys changed since the last call
+	void SaveChanges(DataWriter& writer);
+
+	// Apply changes written by SaveChanges on top of the loaded world
+	void LoadChanges(DataReader& reader);
+
 	auto& GlobalKeys() {
 		return m_globalKeys;
 	}
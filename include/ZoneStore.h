@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstdio>
+#include <memory>
+#include <optional>
+
+#include "VUtils.h"
+#include "HashUtils.h"
+#include "Vector.h"
+
+// Paging file for the ZDOs of zones evicted from memory
+//  Each zone is a zstd compressed chunk of ZDO records, laid out as in the world db
+//  Chunks are only appended, and replaced chunks are garbage until compacted
+//  The file is scratch space for the session; the world db remains the save format
+class ZoneStore {
+public:
+    struct Chunk {
+        uint64_t m_offset;
+        uint32_t m_size;    // compressed bytes
+        uint32_t m_count;   // ZDO records
+    };
+
+private:
+    fs::path m_path;
+    FILE* m_file = nullptr;
+
+    UNORDERED_MAP_t<Vector2i, Chunk> m_chunks;
+
+    uint64_t m_end = 0;
+    uint64_t m_liveSize = 0;
+    size_t m_count = 0;
+
+    // Held by saves still reading chunks
+    std::shared_ptr<bool> m_pin = std::make_shared<bool>();
+
+private:
+    void Remove(decltype(m_chunks)::iterator itr);
+
+public:
+    // Create an empty paging file
+    //  Throws if it cannot be created
+    explicit ZoneStore(fs::path path);
+
+    ZoneStore(const ZoneStore&) = delete;
+
+    // Deletes the paging file
+    ~ZoneStore();
+
+    const fs::path& Path() const {
+        return m_path;
+    }
+
+    bool Contains(Vector2i zone) const {
+        return m_chunks.contains(zone);
+    }
+
+    // Store the ZDO records of a zone, replacing any before
+    //  Throws on failure
+    void Write(Vector2i zone, const BYTES_t& records, uint32_t count);
+
+    // Remove and return the ZDO records of a zone and their count
+    //  Throws on failure
+    std::optional<std::pair<BYTES_t, uint32_t>> Take(Vector2i zone);
+
+    // Read the records of a chunk using a separate handle to the paging file
+    //  Threadsafe while the store is pinned
+    static BYTES_t Read(FILE* file, const Chunk& chunk);
+
+    // Keep chunk offsets valid until the pin is released
+    std::shared_ptr<bool> Pin() const {
+        return m_pin;
+    }
+
+    // Rewrite the file without garbage once it outweighs the chunks
+    //  Does nothing while pinned
+    void Compact();
+
+    // Get every stored chunk
+    std::vector<Chunk> Chunks() const;
+
+    // Number of stored ZDO records
+    size_t size() const {
+        return m_count;
+    }
+
+    bool empty() const {
+        return m_chunks.empty();
+    }
+
+    size_t GetFileSize() const {
+        return m_end;
+    }
+};
@@ -0,0 +1,86 @@
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#include <fcntl.h>
+#endif
+
+#include "DataFileWriter.h"
+
+DataFileWriter::DataFileWriter(fs::path path, size_t flushSize)
+    : DataStream(m_buffer), DataWriter(m_buffer), m_path(std::move(path)), m_flushSize(flushSize)
+{
+    m_tempPath = m_path;
+    m_tempPath += ".tmp";
+
+    m_file = std::fopen(m_tempPath.string().c_str(), "wb");
+    if (!m_file)
+        throw std::runtime_error("failed to create " + m_tempPath.string());
+
+    m_buffer.reserve(m_flushSize);
+}
+
+DataFileWriter::~DataFileWriter() {
+    if (m_file) {
+        std::fclose(m_file);
+
+        std::error_code err;
+        fs::remove(m_tempPath, err);
+    }
+}
+
+void DataFileWriter::Flush(bool force) {
+    if (Position() < m_flushSize && !force)
+        return;
+
+    assert(Position() == size());
+
+    if (std::fwrite(m_buffer.data(), 1, Position(), m_file) != Position())
+        throw std::runtime_error("failed to write to " + m_tempPath.string());
+
+    m_written += Position();
+
+    // Capacity is kept so the buffer is only allocated once
+    m_buffer.clear();
+    SetPos(0);
+}
+
+void DataFileWriter::Append(const BYTES_t& bytes) {
+    Flush(true);
+
+    if (std::fwrite(bytes.data(), 1, bytes.size(), m_file) != bytes.size())
+        throw std::runtime_error("failed to write to " + m_tempPath.string());
+
+    m_written += bytes.size();
+}
+
+void DataFileWriter::Commit() {
+    Flush(true);
+
+    if (std::fflush(m_file) != 0)
+        throw std::runtime_error("failed to write to " + m_tempPath.string());
+
+#ifdef _WIN32
+    if (_commit(_fileno(m_file)) != 0)
+#else
+    if (fsync(fileno(m_file)) != 0)
+#endif
+        throw std::runtime_error("failed to sync " + m_tempPath.string());
+
+    bool closed = std::fclose(m_file) == 0;
+    m_file = nullptr;
+    if (!closed)
+        throw std::runtime_error("failed to close " + m_tempPath.string());
+
+    fs::rename(m_tempPath, m_path);
+
+#ifndef _WIN32
+    // Sync the directory so the rename itself survives a crash
+    auto dir = m_path.parent_path();
+    int fd = open(dir.empty() ? "." : dir.c_str(), O_RDONLY);
+    if (fd != -1) {
+        fsync(fd);
+        close(fd);
+    }
+#endif
+}
@@ -157,12 +157,15 @@ ZDO* IDungeonManager::TryRegenerateDungeon(ZDO& dungeonZdo) {
         auto rot = dungeonZdo.Rotation();
 
         if (!playerNear) {
-            auto zdos = ZDOManager()->GetZDOs(dungeonZdo.GetZone(), [](const ZDO& zdo) {
-                return zdo.Position().y > 4000 && zdo.GetPrefab().AllFlagsAbsent(Prefab::Flag::PLAYER | Prefab::Flag::TOMBSTONE);
+            // Collect first; destroying ZDOs while visiting the zone would disturb it
+            std::vector<ZDO*> zdos;
+            ZDOManager()->ForEachZDO(dungeonZdo.GetZone(), [&](ZDO& zdo) {
+                if (zdo.Position().y > 4000 && zdo.GetPrefab().AllFlagsAbsent(Prefab::Flag::PLAYER | Prefab::Flag::TOMBSTONE))
+                    zdos.push_back(&zdo);
             });
 
-            for (auto&& ref : zdos) {
-                auto&& zdo = ref.get();
+            for (auto&& ptr : zdos) {
+                auto&& zdo = *ptr;
                 auto&& prefab = zdo.GetPrefab();
 
                 assert(!(prefab.m_hash == Hashes::Object::Player || prefab.m_hash == Hashes::Object::Player_tombstone));
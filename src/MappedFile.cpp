@@ -0,0 +1,99 @@
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "MappedFile.h"
+
+bool MappedFile::Open(const fs::path& path) {
+    Close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+        CloseHandle(file);
+        return false;
+    }
+
+    m_file = file;
+    m_size = static_cast<size_t>(size.QuadPart);
+
+    // Empty files cannot be mapped
+    if (m_size == 0)
+        return true;
+
+    m_mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!m_mapping) {
+        Close();
+        return false;
+    }
+
+    m_data = static_cast<BYTE_t*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+    if (!m_data) {
+        Close();
+        return false;
+    }
+#else
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd == -1)
+        return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return false;
+    }
+
+    m_size = static_cast<size_t>(st.st_size);
+
+    // Empty files cannot be mapped
+    if (m_size == 0) {
+        close(fd);
+        return true;
+    }
+
+    // The mapping holds its own reference to the file
+    void* data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if (data == MAP_FAILED) {
+        m_size = 0;
+        return false;
+    }
+
+    m_data = static_cast<BYTE_t*>(data);
+
+    // The whole file is about to be read
+    madvise(data, m_size, MADV_WILLNEED);
+#endif
+
+    return true;
+}
+
+void MappedFile::Close() {
+#ifdef _WIN32
+    if (m_data)
+        UnmapViewOfFile(m_data);
+    if (m_mapping)
+        CloseHandle(m_mapping);
+    if (m_file)
+        CloseHandle(m_file);
+
+    m_mapping = nullptr;
+    m_file = nullptr;
+#else
+    if (m_data)
+        munmap(m_data, m_size);
+#endif
+
+    m_data = nullptr;
+    m_size = 0;
+}
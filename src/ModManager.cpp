@@ -335,8 +335,10 @@ void IModManager::LoadAPI() {
         "visibleOnMap", &Peer::m_visibleOnMap,
         "admin", &Peer::m_admin,
         "characterID", sol::property([](Peer& self) { return self.m_characterID; }), // return copy
-        "name", sol::readonly(&Peer::m_name), // strings are immutable in Lua similarly to Java
-        "pos", &Peer::m_pos,
+        "name", sol::property([](Peer& self) { return std::string_view(self.m_name); }, // strings are immutable in Lua similarly to Java
+            [](Peer& self, std::string name) { NetManager()->RenamePeer(self, std::move(name)); }),
+        "pos", sol::property([](Peer& self) { return self.m_pos; }, 
+            [](Peer& self, Vector3f pos) { NetManager()->MovePeer(self, pos); }),
         "uuid", sol::property([](Peer& self) { return Int64Wrapper(self.m_uuid); }),
         "socket", sol::readonly(&Peer::m_socket),
         "zdo", sol::property(&Peer::GetZDO),
@@ -695,8 +697,17 @@ void IModManager::LoadAPI() {
     // but still retrieve with ZDOManager... class usertypes will be named by their class names, like IZDOManager...
 
     m_state["ZDOManager"] = ZDOManager();
+    m_state.new_usertype<IZDOManager::Handle>("ZDOHandle",
+        sol::meta_function::equal_to, &IZDOManager::Handle::operator==
+    );
+
     m_state.new_usertype<IZDOManager>("IZDOManager",
-        "GetZDO", &IZDOManager::GetZDO,
+        "GetZDO", sol::overload(
+            sol::resolve<ZDO* (ZDOID)>(&IZDOManager::GetZDO),
+            sol::resolve<ZDO* (IZDOManager::Handle)>(&IZDOManager::GetZDO)
+        ),
+        // Lua may hold ZDOs which are not managed, such as event copies
+        "GetHandle", &IZDOManager::FindHandle,
         "SomeZDOs", sol::overload(
             sol::resolve<std::list<std::reference_wrapper<ZDO>>(Vector3f, float, size_t, const std::function<bool(const ZDO&)>&)>(&IZDOManager::SomeZDOs),
             sol::resolve<std::list<std::reference_wrapper<ZDO>>(Vector3f, float, size_t)>(&IZDOManager::SomeZDOs),
@@ -742,6 +753,10 @@ void IModManager::LoadAPI() {
             sol::resolve<ZDO* (Vector3f, float, HASH_t, Prefab::Flag, Prefab::Flag)>(&IZDOManager::NearestZDO),
             [](IZDOManager& self, Vector3f pos, float radius, std::string_view name) { return self.NearestZDO(pos, radius, VUtils::String::GetStableHashCode(name), Prefab::Flag::NONE, Prefab::Flag::NONE); }
         ),
+        "CountZDOs", sol::overload(
+            &IZDOManager::CountZDOs,
+            [](IZDOManager& self, ZoneID zone, std::string_view name) { return self.CountZDOs(zone, VUtils::String::GetStableHashCode(name)); }
+        ),
         "ForceSendZDO", &IZDOManager::ForceSendZDO,
         //"DestroyZDO", sol::resolve<ZDO&>(&IZDOManager::DestroyZDO),
         "DestroyZDO", sol::overload(
@@ -768,6 +783,7 @@ void IModManager::LoadAPI() {
             //sol::resolve<Peer*(OWNER_t)>(&INetManager::GetPeer),
             sol::resolve<Peer* (std::string_view)>(&INetManager::GetPeerByName)
         ),
+        "GetPeersNear", &INetManager::GetPeersNear,
         "peers", sol::readonly(&INetManager::m_onlinePeers)
     );
 
@@ -140,7 +140,7 @@ void INetManager::OnPeerConnect(Peer& peer) {
 
     // Important
     peer.Register(Hashes::Rpc::C2S_UpdatePos, [this](Peer* peer, Vector3f pos, bool publicRefPos) {
-        peer->m_pos = pos;
+        MovePeer(*peer, pos);
         peer->m_visibleOnMap = publicRefPos; // stupid name
         });
 
@@ -246,6 +246,34 @@ void INetManager::OnPeerConnect(Peer& peer) {
     }
 
     m_onlinePeers.push_back(&peer);
+    IndexPeer(peer);
+}
+
+void INetManager::IndexPeer(Peer& peer) {
+    m_peersByUUID[peer.m_uuid] = &peer;
+    m_peersByName[peer.m_name] = &peer;
+    m_peersByHost[peer.m_socket->GetHostName()] = &peer;
+    m_peersByZone[IZoneManager::WorldToZonePos(peer.m_pos)].push_back(&peer);
+}
+
+void INetManager::UnindexPeer(Peer& peer) {
+    // Only erase entries which still refer to this peer
+    auto&& erase = [&peer](auto&& map, auto&& key) {
+        auto&& find = map.find(key);
+        if (find != map.end() && find->second == &peer)
+            map.erase(find);
+    };
+
+    erase(m_peersByUUID, peer.m_uuid);
+    erase(m_peersByName, peer.m_name);
+    erase(m_peersByHost, peer.m_socket->GetHostName());
+
+    auto&& zone = m_peersByZone.find(IZoneManager::WorldToZonePos(peer.m_pos));
+    if (zone != m_peersByZone.end()) {
+        std::erase(zone->second, &peer);
+        if (zone->second.empty())
+            m_peersByZone.erase(zone);
+    }
 }
 
 Peer* INetManager::GetPeer(std::string_view any) {
@@ -257,30 +285,85 @@ Peer* INetManager::GetPeer(std::string_view any) {
 
 // Return the peer or nullptr
 Peer* INetManager::GetPeerByName(std::string_view name) {
-    for (auto&& peer : m_onlinePeers) {
-        if (peer->m_name == name)
-            return peer;
-    }
+    auto&& find = m_peersByName.find(name);
+    if (find != m_peersByName.end())
+        return find->second;
     return nullptr;
 }
 
 // Return the peer or nullptr
 Peer* INetManager::GetPeerByUUID(OWNER_t uuid) {
-    for (auto&& peer : m_onlinePeers) {
-        if (peer->m_uuid == uuid)
-            return peer;
-    }
+    auto&& find = m_peersByUUID.find(uuid);
+    if (find != m_peersByUUID.end())
+        return find->second;
     return nullptr;
 }
 
 Peer* INetManager::GetPeerByHost(std::string_view host) {
-    for (auto&& peer : m_onlinePeers) {
-        if (peer->m_socket->GetHostName() == host)
-            return peer;
-    }
+    auto&& find = m_peersByHost.find(host);
+    if (find != m_peersByHost.end())
+        return find->second;
     return nullptr;
 }
 
+std::vector<Peer*> INetManager::GetPeersNear(Vector3f pos, float radius) {
+    std::vector<Peer*> peers;
+
+    auto&& min = IZoneManager::WorldToZonePos(Vector3f(pos.x - radius, pos.y, pos.z - radius));
+    auto&& max = IZoneManager::WorldToZonePos(Vector3f(pos.x + radius, pos.y, pos.z + radius));
+
+    for (auto z = min.y; z <= max.y; z++) {
+        for (auto x = min.x; x <= max.x; x++) {
+            auto&& find = m_peersByZone.find(ZoneID(x, z));
+            if (find == m_peersByZone.end())
+                continue;
+
+            for (auto&& peer : find->second) {
+                if (peer->m_pos.SqDistance(pos) <= radius * radius)
+                    peers.push_back(peer);
+            }
+        }
+    }
+
+    return peers;
+}
+
+bool INetManager::RenamePeer(Peer& peer, std::string name) {
+    // Peers which are not yet online are not indexed
+    if (m_peersByUUID.find(peer.m_uuid) == m_peersByUUID.end()) {
+        peer.m_name = std::move(name);
+        return true;
+    }
+
+    auto&& other = GetPeerByName(name);
+    if (other && other != &peer)
+        return false;
+
+    m_peersByName.erase(peer.m_name);
+    peer.m_name = std::move(name);
+    m_peersByName[peer.m_name] = &peer;
+    return true;
+}
+
+void INetManager::MovePeer(Peer& peer, Vector3f pos) {
+    auto prevZone = IZoneManager::WorldToZonePos(peer.m_pos);
+    auto zone = IZoneManager::WorldToZonePos(pos);
+
+    peer.m_pos = pos;
+
+    if (prevZone == zone)
+        return;
+
+    auto&& prev = m_peersByZone.find(prevZone);
+    if (prev == m_peersByZone.end() || std::erase(prev->second, &peer) == 0)
+        return; // not online
+
+    if (prev->second.empty())
+        m_peersByZone.erase(prev);
+
+    m_peersByZone[zone].push_back(&peer);
+}
+
 void INetManager::PostInit() {
     LOG_INFO(LOGGER, "Initializing NetManager");
 
@@ -528,6 +611,8 @@ void INetManager::OnPeerQuit(Peer& peer) {
     VH_DISPATCH_MOD_EVENT(IModManager::Events::Quit, peer);
     ZDOManager()->OnPeerQuit(peer);
 
+    UnindexPeer(peer);
+
     if (peer.m_admin)
         Valhalla()->m_admin.insert(peer.m_socket->GetHostName());
     else
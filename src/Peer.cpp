@@ -180,18 +180,53 @@ void Peer::ZDOSectorInvalidated(ZDO& zdo) {
         return;
 
     if (!ZoneManager()->ZonesOverlap(zdo.GetZone(), m_pos)) {
-        if (m_zdos.erase(zdo.ID())) {
+        if (ForgetZDO(zdo)) {
             m_invalidSector.insert(zdo.ID());
         }
     }
 }
 
-bool Peer::IsOutdatedZDO(ZDO& zdo, decltype(m_zdos)::iterator& outItr) {
-    auto&& find = m_zdos.find(zdo.ID());
+Peer::KnownZDO* Peer::GetKnownZDO(const ZDO& zdo) {
+    auto handle = ZDOManager()->GetHandle(zdo);
 
-    outItr = find;
+    auto page = handle.m_index / KNOWN_ZDO_PAGE_SIZE;
+    if (page >= m_knownZDOs.size() || !m_knownZDOs[page])
+        return nullptr;
 
-    return find == m_zdos.end()
-        || zdo.GetOwnerRevision() > find->second.first.m_ownerRev
-        || zdo.m_dataRev > find->second.first.m_dataRev;
+    auto&& known = (*m_knownZDOs[page])[handle.m_index % KNOWN_ZDO_PAGE_SIZE];
+    if (known.m_generation != handle.m_generation)
+        return nullptr;
+
+    return &known;
+}
+
+void Peer::SetKnownZDO(const ZDO& zdo, ZDO::Rev rev, float time) {
+    auto handle = ZDOManager()->GetHandle(zdo);
+
+    auto page = handle.m_index / KNOWN_ZDO_PAGE_SIZE;
+    if (page >= m_knownZDOs.size())
+        m_knownZDOs.resize(page + 1);
+
+    auto&& ptr = m_knownZDOs[page];
+    if (!ptr)
+        ptr = std::make_unique<KnownZDOPage>();
+
+    (*ptr)[handle.m_index % KNOWN_ZDO_PAGE_SIZE] = { handle.m_generation, rev, time };
+}
+
+bool Peer::ForgetZDO(const ZDO& zdo) {
+    if (auto known = GetKnownZDO(zdo)) {
+        // Never matches a live slot (those have odd generations)
+        known->m_generation = 0;
+        return true;
+    }
+    return false;
+}
+
+bool Peer::IsOutdatedZDO(ZDO& zdo, KnownZDO*& outKnown) {
+    outKnown = GetKnownZDO(zdo);
+
+    return !outKnown
+        || zdo.GetOwnerRevision() > outKnown->m_rev.m_ownerRev
+        || zdo.m_dataRev > outKnown->m_rev.m_dataRev;
 }
\ No newline at end of file
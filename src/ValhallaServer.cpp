@@ -346,12 +346,20 @@ void IValhalla::LoadFiles(bool reloading) {
             a(m_settings.worldVegetation, world, "vegetation", true);
             a(m_settings.worldCreatures, world, "creatures", true);
             a(m_settings.worldHeightmapThreads, world, "heightmap-threads", 1, [](uint32_t val) { return val == 0 || val >= std::jthread::hardware_concurrency(); }, reloading);
+            a(m_settings.worldSaveThreads, world, "save-threads", 2, [](unsigned int val) { return val >= std::jthread::hardware_concurrency(); }, reloading);
+            a(m_settings.worldJournalInterval, world, "journal-interval", 5s, [](seconds val) { return val < 0s; }, reloading);
+            a(m_settings.worldBackupThreads, world, "backup-threads", 2, [](unsigned int val) { return val >= std::jthread::hardware_concurrency(); }, reloading);
+            a(m_settings.worldBackupDeltas, world, "backup-deltas", 0, [](unsigned int val) { return val > 100; }, reloading);
+            a(m_settings.worldPagingDelay, world, "paging-delay", 0s, [](seconds val) { return val < 0s; }, reloading);
                         
             a(m_settings.zdoSendInterval, zdo, "send-interval", 50ms, [](seconds val) { return val <= 0s || val > 1s; });
             a(m_settings.zdoMaxCongestion, zdo, "max-send-threshold", 10240, [](int val) { return val < 1000; });
             a(m_settings.zdoMinCongestion, zdo, "min-send-threshold", 2048, [](int val) { return val < 1000; });
             a(m_settings.zdoAssignInterval, zdo, "assign-interval", 2s, [](seconds val) { return val <= 0s || val > 10s; });
             a(m_settings.zdoAssignAlgorithm, zdo, "assign-algorithm", AssignAlgorithm::NONE);
+            a(m_settings.zdoAssignHysteresis, zdo, "assign-hysteresis", 8.f, [](float val) { return val < 0; });
+            a(m_settings.zdoInternMembers, zdo, "intern-members", true);
+            a(m_settings.zdoSyncThreads, zdo, "sync-threads", 2, [](unsigned int val) { return val >= std::jthread::hardware_concurrency(); }, reloading);
             
             a(m_settings.dungeonsEnabled, dungeons, "enabled", true);
             {
@@ -621,7 +629,9 @@ void IValhalla::Start() {
 #ifdef VH_OPTION_ENABLE_CAPTURE
     if (VH_SETTINGS.packetMode != PacketMode::PLAYBACK)
 #endif
-        WorldManager()->GetWorld()->WriteFiles();
+        WorldManager()->GetWorld()->WriteFiles(true);
+
+    WorldManager()->Uninit();
 
     {
         YAML::Node node(m_blacklist);
@@ -690,6 +700,7 @@ void IValhalla::Update() {
     ZoneManager()->Update();
     RandomEventManager()->Update();
     HeightmapBuilder()->Update();
+    WorldManager()->Update();
 }
 
 void IValhalla::PeriodUpdate() {
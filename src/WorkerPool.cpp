@@ -0,0 +1,73 @@
+#include "WorkerPool.h"
+
+void WorkerPool::Start(unsigned int threads, std::string_view name) {
+    for (unsigned int i = 0; i < threads; i++) {
+        m_threads.emplace_back([this, i, name = std::string(name)](std::stop_token token) {
+            std::string threadName = name + std::to_string(i);
+
+            tracy::SetThreadName(threadName.c_str());
+
+            uint64_t generation = 0;
+            while (true) {
+                {
+                    std::unique_lock<std::mutex> lock(m_mux);
+                    if (!m_wake.wait(lock, token, [&]() { return m_generation != generation; }))
+                        return;
+
+                    generation = m_generation;
+                }
+
+                Work();
+
+                {
+                    std::scoped_lock<std::mutex> scoped(m_mux);
+                    if (--m_busy == 0)
+                        m_done.notify_one();
+                }
+            }
+        });
+    }
+}
+
+void WorkerPool::Stop() {
+    // First request all to stop
+    for (auto&& thread : m_threads)
+        thread.request_stop();
+
+    // Then join each
+    for (auto&& thread : m_threads) {
+        if (thread.joinable())
+            thread.join();
+    }
+
+    m_threads.clear();
+}
+
+void WorkerPool::Work() {
+    for (size_t i; (i = m_next.fetch_add(1, std::memory_order_relaxed)) < m_count; )
+        (*m_job)(i);
+}
+
+void WorkerPool::Run(size_t count, const std::function<void(size_t)>& job) {
+    if (m_threads.empty() || count <= 1) {
+        for (size_t i = 0; i < count; i++)
+            job(i);
+        return;
+    }
+
+    {
+        std::scoped_lock<std::mutex> scoped(m_mux);
+        m_job = &job;
+        m_count = count;
+        m_next = 0;
+        m_busy = m_threads.size();
+        m_generation++;
+    }
+    m_wake.notify_all();
+
+    Work();
+
+    std::unique_lock<std::mutex> lock(m_mux);
+    m_done.wait(lock, [this]() { return m_busy == 0; });
+    m_job = nullptr;
+}
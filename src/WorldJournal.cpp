@@ -0,0 +1,153 @@
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#include <charconv>
+
+#include "WorldJournal.h"
+#include "DataWriter.h"
+#include "VUtilsResource.h"
+
+// Batch header:
+//  uint32_t:   size
+//  uint64_t:   checksum of the batch
+static constexpr size_t BATCH_HEADER_SIZE = sizeof(uint32_t) + sizeof(uint64_t);
+
+static uint64_t Checksum(const BYTE_t* data, size_t size) {
+    return ankerl::unordered_dense::detail::wyhash::hash(data, size);
+}
+
+WorldJournal::WorldJournal(fs::path dbPath)
+    : m_dbPath(std::move(dbPath)) {}
+
+WorldJournal::~WorldJournal() {
+    if (m_file)
+        std::fclose(m_file);
+}
+
+fs::path WorldJournal::SegmentPath(uint32_t segment) const {
+    auto path = m_dbPath;
+    path += ".journal." + std::to_string(segment);
+    return path;
+}
+
+std::vector<uint32_t> WorldJournal::Segments() const {
+    std::vector<uint32_t> segments;
+
+    const auto prefix = m_dbPath.filename().string() + ".journal.";
+    auto dir = m_dbPath.parent_path();
+
+    std::error_code err;
+    for (auto&& entry : fs::directory_iterator(dir.empty() ? "." : dir, err)) {
+        auto name = entry.path().filename().string();
+        if (!name.starts_with(prefix))
+            continue;
+
+        uint32_t segment;
+        auto first = name.data() + prefix.size();
+        auto last = name.data() + name.size();
+        auto result = std::from_chars(first, last, segment);
+        if (result.ec == std::errc() && result.ptr == last)
+            segments.push_back(segment);
+    }
+
+    std::sort(segments.begin(), segments.end());
+    return segments;
+}
+
+size_t WorldJournal::Replay(const std::function<void(DataReader&)>& func) const {
+    size_t count = 0;
+
+    for (auto segment : Segments()) {
+        auto bytes = VUtils::Resource::ReadFile<BYTES_t>(SegmentPath(segment));
+        if (!bytes)
+            throw std::runtime_error("failed to read " + SegmentPath(segment).string());
+
+        DataReader reader(*bytes);
+        while (reader.Position() + BATCH_HEADER_SIZE <= reader.size()) {
+            auto size = reader.Read<uint32_t>();
+            auto checksum = reader.Read<uint64_t>();
+
+            // The batch being written when the server stopped
+            if (reader.Position() + size > reader.size()
+                || Checksum(bytes->data() + reader.Position(), size) != checksum)
+            {
+                LOG_WARNING(LOGGER, "Ignoring torn batch in journal segment {}", segment);
+                break;
+            }
+
+            DataReader batch(BYTE_VIEW_t(bytes->data() + reader.Position(), size));
+            func(batch);
+
+            reader.SetPos(reader.Position() + size);
+            count++;
+        }
+    }
+
+    return count;
+}
+
+void WorldJournal::Open() {
+    auto segments = Segments();
+    m_segment = segments.empty() ? 0 : segments.back() + 1;
+
+    auto path = SegmentPath(m_segment);
+    m_file = std::fopen(path.string().c_str(), "wb");
+    if (!m_file)
+        throw std::runtime_error("failed to create " + path.string());
+}
+
+void WorldJournal::Append(const BYTES_t& batch) {
+    if (!m_file)
+        throw std::runtime_error("journal is not open");
+
+    BYTES_t header;
+    {
+        DataWriter writer(header);
+        writer.Write<uint32_t>(batch.size());
+        writer.Write(Checksum(batch.data(), batch.size()));
+    }
+
+    if (std::fwrite(header.data(), 1, header.size(), m_file) != header.size()
+        || std::fwrite(batch.data(), 1, batch.size(), m_file) != batch.size()
+        || std::fflush(m_file) != 0)
+        throw std::runtime_error("failed to write to " + SegmentPath(m_segment).string());
+
+#ifdef _WIN32
+    _commit(_fileno(m_file));
+#else
+    fsync(fileno(m_file));
+#endif
+}
+
+uint32_t WorldJournal::Seal() {
+    if (!m_file) {
+        auto segments = Segments();
+        return segments.empty() ? 0 : segments.back();
+    }
+
+    const auto sealed = m_segment;
+
+    std::fclose(m_file);
+    m_file = nullptr;
+
+    m_segment++;
+    auto path = SegmentPath(m_segment);
+    m_file = std::fopen(path.string().c_str(), "wb");
+    if (!m_file)
+        throw std::runtime_error("failed to create " + path.string());
+
+    return sealed;
+}
+
+void WorldJournal::Discard(uint32_t segment) const {
+    for (auto other : Segments()) {
+        if (other > segment)
+            break;
+
+        std::error_code err;
+        fs::remove(SegmentPath(other), err);
+    }
+}
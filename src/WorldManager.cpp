@@ -1,4 +1,5 @@
 #include <future>
+#include <bit>
 
 #include "WorldManager.h"
 #include "VUtils.h"
@@ -10,6 +11,8 @@
 #include "ZoneManager.h"
 #include "NetManager.h"
 #include "RandomEventManager.h"
+#include "DataFileWriter.h"
+#include "MappedFile.h"
 
 auto WORLD_MANAGER(std::make_unique<IWorldManager>());
 IWorldManager* WorldManager() {
@@ -18,6 +21,150 @@ IWorldManager* WorldManager() {
 
 
 
+// State of the world at the moment a save began
+struct WorldSnapshot {
+	double m_worldTime;
+	IZDOManager::SaveSnapshot m_zdos;
+	// Zones and events are small, so are serialized immediately
+	BYTES_t m_tail;
+};
+
+static BYTES_t SerializeWorldDB(WorkerPool& workers, const WorldSnapshot& snapshot) {
+	BYTES_t bytes;
+	DataWriter writer(bytes);
+
+	writer.Write(VConstants::WORLD);
+	writer.Write(snapshot.m_worldTime);
+
+	IZDOManager::Save(workers, snapshot.m_zdos, [&bytes](const BYTES_t& shard) {
+		bytes.insert(bytes.end(), shard.begin(), shard.end());
+	});
+	bytes.insert(bytes.end(), snapshot.m_tail.begin(), snapshot.m_tail.end());
+
+	return bytes;
+}
+
+// Compressed copy of a db, made from the bytes as they are saved
+//	Deltas are compressed against the db being replaced, so are restored
+//	with 'zstd -d --long=31 --patch-from=<previous db>'
+class WorldBackup {
+private:
+	MappedFile m_previous;
+	bool m_delta;
+
+	fs::path m_path;
+	ZStdStreamCompressor m_compressor;
+	DataFileWriter m_file;
+
+	BYTES_t m_compressed;
+
+private:
+	// The window must span the previous db to find matches within it
+	int WindowLog() const {
+		if (!m_delta)
+			return 27;
+
+		auto bounds = ZSTD_cParam_getBounds(ZSTD_c_windowLog);
+		return std::clamp(static_cast<int>(std::bit_width(m_previous.size() * 2)), 27, bounds.upperBound);
+	}
+
+	static fs::path BackupPath(const fs::path& dbPath, bool delta) {
+		auto now(std::to_string(steady_clock::now().time_since_epoch().count()));
+		return dbPath.string() + "-" + now + (delta ? "-delta.zstd" : ".zstd");
+	}
+
+public:
+	// Throws if the backup file cannot be created
+	WorldBackup(const fs::path& dbPath, bool delta)
+		: m_delta(delta && m_previous.Open(dbPath) && m_previous.size()),
+		m_path(BackupPath(dbPath, m_delta)),
+		m_compressor(ZSTD_CLEVEL_DEFAULT, VH_SETTINGS.worldBackupThreads, true, WindowLog()),
+		m_file(m_path)
+	{
+		if (m_delta)
+			m_compressor.SetPrefix(m_previous.View().data(), m_previous.size());
+		else
+			m_previous.Close();
+	}
+
+	bool IsDelta() const {
+		return m_delta;
+	}
+
+	const fs::path& Path() const {
+		return m_path;
+	}
+
+	void Append(const BYTES_t& bytes) {
+		m_compressor.Compress(bytes, m_compressed);
+		if (m_compressed.size() >= 1024 * 1024) {
+			m_file.Append(m_compressed);
+			m_compressed.clear();
+		}
+	}
+
+	// Finish the backup, and release the previous db
+	//	Returns the compressed size
+	size_t Commit() {
+		m_compressor.Finish(m_compressed);
+		m_file.Append(m_compressed);
+		m_compressed.clear();
+		m_file.Commit();
+
+		m_previous.Close();
+		return m_file.Written();
+	}
+};
+
+// Stream the db to a file without holding the whole image in memory
+//	The backup is compressed from the same bytes, and is reset if it fails
+static size_t WriteFileWorldDB(WorkerPool& workers, const fs::path& path, const WorldSnapshot& snapshot, std::unique_ptr<WorldBackup>& backup) {
+	DataFileWriter writer(path);
+
+	auto append = [&writer, &backup](const BYTES_t& bytes) {
+		writer.Append(bytes);
+
+		if (backup) {
+			try {
+				backup->Append(bytes);
+			}
+			catch (const std::exception& e) {
+				LOG_ERROR(LOGGER, "Failed to compress world backup: {}", e.what());
+				backup.reset();
+			}
+		}
+	};
+
+	BYTES_t header;
+	{
+		DataWriter headerWriter(header);
+		headerWriter.Write(VConstants::WORLD);
+		headerWriter.Write(snapshot.m_worldTime);
+	}
+	append(header);
+
+	IZDOManager::Save(workers, snapshot.m_zdos, append);
+	append(snapshot.m_tail);
+
+	// A delta backup still reads the db being replaced, so is finished first
+	if (backup) {
+		try {
+			auto size = backup->Commit();
+			LOG_INFO(LOGGER, "Saved world {}backup as '{}' ({} bytes)", backup->IsDelta() ? "delta " : "", backup->Path().string(), size);
+		}
+		catch (const std::exception& e) {
+			LOG_ERROR(LOGGER, "Failed to save world backup: {}", e.what());
+			backup.reset();
+		}
+	}
+
+	writer.Commit();
+
+	return writer.Written();
+}
+
+
+
 World::World(std::string name, std::string seedName) {
 	m_name = std::move(name);
 	m_seedName = std::move(seedName);
@@ -102,11 +249,15 @@ void World::WriteFileDB(const fs::path& root) {
 
 	auto path(root / (m_name + ".db"));
 
-	if (VUtils::Resource::WriteFile(path, bytes)) {
+	// The loaded db may still be mapped, so it is replaced rather than overwritten
+	try {
+		DataFileWriter writer(path);
+		writer.Append(bytes);
+		writer.Commit();
 		LOG_INFO(LOGGER, "World save to {} took {}s", path.string(), duration_cast<milliseconds>(finishTime - startTime).count());
 	}
-	else {
-		LOG_WARNING(LOGGER, "Failed to save world to {}", path.string());
+	catch (const std::exception& e) {
+		LOG_WARNING(LOGGER, "Failed to save world to {}: {}", path.string(), e.what());
 	}
 }
 
@@ -114,9 +265,12 @@ void World::LoadFileDB(const fs::path& root) {
 	auto now(steady_clock::now());
 
 	auto path(root / (m_name + ".db"));
-	if (auto opt = VUtils::Resource::ReadFile<BYTES_t>(path)) {
+
+	// Records are read straight out of the mapping instead of a copy of the file
+	auto file = std::make_unique<MappedFile>();
+	if (file->Open(path)) {
 		try {
-			DataReader reader(opt.value());
+			DataReader reader(file->View());
 
 			auto worldVersion = reader.Read<int32_t>();
 			if (worldVersion != VConstants::WORLD) {
@@ -134,7 +288,14 @@ void World::LoadFileDB(const fs::path& root) {
 
 			//VLOG(1) << "World time: " << Valhalla()->m_worldTime;
 
+#ifdef _WIN32
+			// A mapped file cannot be replaced on Windows, so ZDOs are fully decoded
 			ZDOManager()->Load(reader, worldVersion);
+#else
+			// ZDOs keep referencing their records, so the mapping is handed over
+			//	Saves replace the file rather than writing into it, so the mapping stays valid
+			ZDOManager()->Load(reader, worldVersion, std::move(file));
+#endif
 
 			if (worldVersion >= 12)
 				ZoneManager()->Load(reader, worldVersion);
@@ -150,36 +311,11 @@ void World::LoadFileDB(const fs::path& root) {
 	}	
 }
 
-void World::CopyCompressDB(const fs::path& root) {
-	auto path = root / (m_name + ".db");
-
-	if (fs::exists(path)) {
-		if (auto oldSave = VUtils::Resource::ReadFile<BYTES_t>(path)) {
-			auto compressed = ZStdCompressor().Compress(*oldSave);
-			if (!compressed) {
-				LOG_ERROR(LOGGER, "Failed to compress world backup {}", path);
-				return;
-			}
-
-			auto now(std::to_string(steady_clock::now().time_since_epoch().count()));
-			auto backup = path.string() + "-" + now + ".zstd";
-			if (VUtils::Resource::WriteFile(backup, *compressed)) {
-				LOG_INFO(LOGGER, "Saved world backup as '{}'", backup);
-			}
-			else {
-				LOG_ERROR(LOGGER, "Failed to save world backup to {}", backup);
-			}
-		}
-		else {
-			LOG_ERROR(LOGGER, "Failed to load old world for backup");
-		}
-	}
-}
-
-void World::WriteFiles(const fs::path& root) {
+void World::WriteFiles(const fs::path& root, bool sync) {
 	WriteFileMeta(root);
-	WriteFileDB(root);
-	CopyCompressDB(root);
+	WorldManager()->BeginSave(root);
+	if (sync)
+		WorldManager()->FinishSave();
 }
 
 
@@ -196,12 +332,14 @@ void World::LoadFileDB() {
 	LoadFileDB(WorldManager()->GetWorldsPath());
 }
 
-void World::WriteFiles() {
-	WriteFiles(WorldManager()->GetWorldsPath());
+void World::WriteFiles(bool sync) {
+	WriteFiles(WorldManager()->GetWorldsPath(), sync);
 }
 
 
 
+IWorldManager::~IWorldManager() = default;
+
 World* IWorldManager::GetWorld() {
 	return m_world.get();
 }
@@ -267,18 +405,103 @@ std::unique_ptr<World> IWorldManager::RetrieveWorld(std::string_view name, std::
 	return world;
 }
 
-BYTES_t IWorldManager::SaveWorldDB() const {
-	BYTES_t bytes;
-	DataWriter writer(bytes);
-	
-	writer.Write(VConstants::WORLD);
-	writer.Write(Valhalla()->GetWorldTime());
+std::unique_ptr<WorldSnapshot> IWorldManager::Snapshot() const {
+	auto snapshot = std::make_unique<WorldSnapshot>();
+	snapshot->m_worldTime = Valhalla()->GetWorldTime();
+	snapshot->m_zdos = ZDOManager()->Snapshot();
 
-	ZDOManager()->Save(writer);
+	DataWriter writer(snapshot->m_tail);
 	ZoneManager()->Save(writer);	
 	RandomEventManager()->Save(writer);
-	
-	return bytes;
+
+	return snapshot;
+}
+
+BYTES_t IWorldManager::SaveWorldDB() {
+	// The workers are free once no save is running
+	FinishSave();
+
+	return SerializeWorldDB(m_saveWorkers, *Snapshot());
+}
+
+void IWorldManager::BeginSave(const fs::path& root) {
+	ZoneScoped;
+
+	FinishSave();
+
+	// The segments so far only hold changes which the snapshot includes,
+	//	so are discarded once it is written
+	WorldJournal* journal = nullptr;
+	uint32_t sealed = 0;
+	if (m_journal && m_journal->DBPath() == root / (m_world->m_name + ".db")) {
+		journal = m_journal.get();
+		if (journal->IsOpen())
+			WriteJournal();
+
+		try {
+			sealed = journal->Seal();
+		}
+		catch (const std::exception& e) {
+			LOG_ERROR(LOGGER, "Failed to start world journal segment: {}", e.what());
+		}
+	}
+
+	auto startTime(steady_clock::now());
+	auto snapshot = Snapshot();
+	LOG_INFO(LOGGER, "World snapshot took {}ms", duration_cast<milliseconds>(steady_clock::now() - startTime).count());
+
+	m_save = std::async(std::launch::async, [this, root, world = m_world.get(), snapshot = std::move(snapshot), journal, sealed]() mutable {
+		tracy::SetThreadName("WorldSave");
+
+		fs::create_directories(root);
+
+		auto path(root / (world->m_name + ".db"));
+
+		// Only saves touch the backup count, and they never overlap
+		const bool delta = m_backupDeltas >= 0 && m_backupDeltas < static_cast<int>(VH_SETTINGS.worldBackupDeltas);
+
+		std::unique_ptr<WorldBackup> backup;
+		try {
+			backup = std::make_unique<WorldBackup>(path, delta);
+		}
+		catch (const std::exception& e) {
+			LOG_ERROR(LOGGER, "Failed to start world backup: {}", e.what());
+		}
+
+		try {
+			auto startTime(steady_clock::now());
+			auto size = WriteFileWorldDB(m_saveWorkers, path, *snapshot, backup);
+			LOG_INFO(LOGGER, "World save to {} ({} bytes) took {}ms", path.string(), size, duration_cast<milliseconds>(steady_clock::now() - startTime).count());
+		}
+		catch (const std::exception& e) {
+			LOG_WARNING(LOGGER, "Failed to save world to {}: {}", path.string(), e.what());
+
+			// The db a delta would be made against was not replaced
+			m_backupDeltas = -1;
+			return std::move(snapshot);
+		}
+
+		if (backup)
+			m_backupDeltas = backup->IsDelta() ? m_backupDeltas + 1 : 0;
+
+		if (journal)
+			journal->Discard(sealed);
+
+		return std::move(snapshot);
+	});
+}
+
+void IWorldManager::FinishSave() {
+	if (!m_save.valid())
+		return;
+
+	try {
+		// The snapshot is released here to keep shared ZDO values on the main thread
+		m_save.get();
+	}
+	catch (const std::exception& e) {
+		LOG_ERROR(LOGGER, "Severe error while saving world: {}", e.what());
+	}
 }
 
 /*
@@ -332,6 +555,8 @@ void IWorldManager::WriteWorldFiles(const fs::path& root) {
 void IWorldManager::PostZoneInit() {
 	LOG_INFO(LOGGER, "Initializing WorldManager");
 
+	m_saveWorkers.Start(VH_SETTINGS.worldSaveThreads, "WorldSave");
+
 	m_world = RetrieveWorld(VH_SETTINGS.worldName, VH_SETTINGS.worldSeed);
 
 #ifdef VH_OPTION_ENABLE_CAPTURE
@@ -347,7 +572,67 @@ void IWorldManager::PostZoneInit() {
 	}
 	else
 #endif
+	{
 		m_world->LoadFileDB();
+		OpenJournal(GetWorldsPath());
+
+		if (VH_SETTINGS.worldPagingDelay > 0s) {
+			try {
+				ZDOManager()->StartPaging(GetWorldsPath() / (m_world->m_name + ".db.zones"));
+			}
+			catch (const std::exception& e) {
+				LOG_ERROR(LOGGER, "Failed to start zone paging: {}", e.what());
+			}
+		}
+	}
+}
+
+void IWorldManager::OpenJournal(const fs::path& root) {
+	m_journal = std::make_unique<WorldJournal>(root / (m_world->m_name + ".db"));
+
+	// Segments are replayed even if journaling is now disabled,
+	//	and discarded by the next save
+	try {
+		auto count = m_journal->Replay([](DataReader& reader) {
+			auto version = reader.Read<int32_t>();
+			Valhalla()->m_worldTime = reader.Read<double>();
+			ZDOManager()->LoadChanges(reader, version);
+			ZoneManager()->LoadChanges(reader);
+		});
+
+		if (count)
+			LOG_INFO(LOGGER, "Replayed {} world journal batches", count);
+
+		if (VH_SETTINGS.worldJournalInterval > 0s) {
+			m_journal->Open();
+			ZDOManager()->TrackChanges();
+			ZoneManager()->TrackChanges();
+		}
+	}
+	catch (const std::exception& e) {
+		LOG_ERROR(LOGGER, "Failed to open world journal: {}", e.what());
+	}
+}
+
+void IWorldManager::WriteJournal() {
+	ZoneScoped;
+
+	BYTES_t batch;
+	{
+		DataWriter writer(batch);
+		writer.Write(VConstants::WORLD);
+		writer.Write(Valhalla()->m_worldTime);
+		ZDOManager()->SaveChanges(writer);
+		ZoneManager()->SaveChanges(writer);
+	}
+
+	// The changes are still held by the next save
+	try {
+		m_journal->Append(batch);
+	}
+	catch (const std::exception& e) {
+		LOG_ERROR(LOGGER, "Failed to write world journal: {}", e.what());
+	}
 }
 
 void IWorldManager::PostInit() {
@@ -366,3 +651,19 @@ void IWorldManager::PostInit() {
 	}
 #endif
 }
+
+void IWorldManager::Update() {
+	if (m_save.valid() && m_save.wait_for(0s) == std::future_status::ready)
+		FinishSave();
+
+	if (m_journal && m_journal->IsOpen()) {
+		PERIODIC_NOW(VH_SETTINGS.worldJournalInterval, {
+			WriteJournal();
+		});
+	}
+}
+
+void IWorldManager::Uninit() {
+	FinishSave();
+	m_saveWorkers.Stop();
+}
@@ -0,0 +1,430 @@
+// WorldTool.cpp
+//  Offline world analysis and compaction
+//  The world is loaded through the same managers as the server,
+//  then reported on, and optionally pruned and written out again
+
+#include <charconv>
+
+#include "VUtils.h"
+#include "ValhallaServer.h"
+#include "ZDOManager.h"
+#include "ZoneManager.h"
+#include "WorldManager.h"
+#include "PrefabManager.h"
+#include "DungeonManager.h"
+#include "RandomEventManager.h"
+#include "WorldJournal.h"
+#include "Hashes.h"
+
+/*
+* Example command line args:
+*   .\ValhallaWorldTool.exe Dedicated
+*   .\ValhallaWorldTool.exe Dedicated --top 50 --threads 8
+*   .\ValhallaWorldTool.exe Dedicated --tombstone-days 30 --compact ./worlds/compacted
+*/
+static constexpr const char* USAGE =
+    "usage: ValhallaWorldTool <world> [options]\n"
+    "  --threads <n>         worker threads besides the main thread\n"
+    "  --top <n>             rows shown per report table (default 20)\n"
+    "  --tombstone-days <n>  prune tombstones older than n in-game days (default 0, never)\n"
+    "  --legacy              keep ZDOs from old world versions\n"
+    "  --compact <dir>       prune the world and write it to dir\n";
+
+// ZDOs tallied together by a single worker
+static constexpr size_t ANALYZE_SHARD_SIZE = 4096;
+
+class WorldTool {
+public:
+    struct Options {
+        std::string m_world;
+        unsigned int m_threads = std::max(1u, std::jthread::hardware_concurrency()) - 1;
+        size_t m_top = 20;
+        int m_tombstoneDays = 0;
+        bool m_legacy = false;
+        std::optional<fs::path> m_compact;
+    };
+
+private:
+    struct Usage {
+        size_t m_count = 0;
+        size_t m_bytes = 0;
+
+        void Add(const Usage& other) {
+            m_count += other.m_count;
+            m_bytes += other.m_bytes;
+        }
+    };
+
+    using Sector = IZDOManager::Sector;
+
+    const Options& m_options;
+
+    WorkerPool m_workers;
+
+    // Every loaded ZDO, including those without a zone
+    //  and copies whose ID was loaded again later
+    std::vector<ZDO*> m_zdos;
+
+    // ZDOs to prune
+    std::vector<ZDO*> m_copies;         // loaded again under the same ID
+    std::vector<ZDOID> m_duplicates;    // same prefab and transform as another
+    std::vector<ZDOID> m_orphans;       // sessioned or outside of the world
+    std::vector<ZDOID> m_tombstones;    // expired
+
+private:
+    template<typename K, typename F>
+    void Report(std::string_view title, const UNORDERED_MAP_t<K, Usage>& usages, F&& name) {
+        std::vector<std::pair<K, Usage>> sorted(usages.begin(), usages.end());
+        std::sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) {
+            return a.second.m_bytes > b.second.m_bytes;
+        });
+
+        LOG_INFO(LOGGER, "Top {} of {} {} by size:", std::min(m_options.m_top, sorted.size()), sorted.size(), title);
+        for (size_t i = 0; i < std::min(m_options.m_top, sorted.size()); i++) {
+            auto&& [key, usage] = sorted[i];
+            LOG_INFO(LOGGER, "  {:>10} zdos {:>12.02f}kb  {}", usage.m_count, usage.m_bytes / 1000.f, name(key));
+        }
+    }
+
+    // Gather every ZDO and those loaded twice under the same ID
+    void Gather() {
+        auto&& zdoManager = *ZDOManager();
+
+        m_zdos.reserve(zdoManager.m_objectsByID.size());
+        for (auto&& pair : zdoManager.m_objectsBySector) {
+            for (auto zdo : pair.second.m_zdos) {
+                m_zdos.push_back(zdo);
+
+                // The ID only refers to the copy loaded last
+                if (zdoManager.m_objectsByID[zdo->ID()] != zdo)
+                    m_copies.push_back(zdo);
+            }
+        }
+
+        // ZDOs outside of the world are not within any zone
+        for (auto&& pair : zdoManager.m_objectsByID) {
+            if (zdoManager.SectorToIndex(pair.second->GetZone()) == -1) {
+                m_zdos.push_back(pair.second);
+                m_orphans.push_back(pair.first);
+            }
+            else if (pair.second->GetPrefab().AllFlagsPresent(Prefab::Flag::SESSIONED)) {
+                m_orphans.push_back(pair.first);
+            }
+        }
+    }
+
+    // Tally the saved size of each ZDO by prefab and zone
+    void Analyze() {
+        ZoneScoped;
+
+        struct Tally {
+            UNORDERED_MAP_t<HASH_t, Usage> m_prefabs;
+            UNORDERED_MAP_t<ZoneID, Usage> m_zones;
+        };
+
+        const size_t shardCount = (m_zdos.size() + ANALYZE_SHARD_SIZE - 1) / ANALYZE_SHARD_SIZE;
+        std::vector<Tally> tallies(shardCount);
+
+        // Saving only reads a ZDO, so they can be measured in parallel
+        m_workers.Run(shardCount, [&](size_t i) {
+            auto&& tally = tallies[i];
+
+            BYTES_t bytes;
+            const auto begin = i * ANALYZE_SHARD_SIZE;
+            const auto end = std::min(begin + ANALYZE_SHARD_SIZE, m_zdos.size());
+            for (auto j = begin; j < end; j++) {
+                auto zdo = m_zdos[j];
+
+                bytes.clear();
+                DataWriter writer(bytes);
+                writer.Write(zdo->ID());
+                writer.SubWrite([zdo](DataWriter& writer) {
+                    zdo->Save(writer);
+                });
+
+                Usage usage{ 1, bytes.size() };
+                tally.m_prefabs[zdo->GetPrefab().m_hash].Add(usage);
+                tally.m_zones[zdo->GetZone()].Add(usage);
+            }
+        });
+
+        Tally total;
+        Usage sum;
+        for (auto&& tally : tallies) {
+            for (auto&& [hash, usage] : tally.m_prefabs) {
+                total.m_prefabs[hash].Add(usage);
+                sum.Add(usage);
+            }
+            for (auto&& [zone, usage] : tally.m_zones)
+                total.m_zones[zone].Add(usage);
+        }
+
+        LOG_INFO(LOGGER, "World has {} zdos ({:.02f}mb)", sum.m_count, sum.m_bytes / 1000000.f);
+
+        Report("prefabs", total.m_prefabs, [](HASH_t hash) {
+            auto prefab = PrefabManager()->GetPrefab(hash);
+            return prefab ? prefab->m_name : std::to_string(hash);
+        });
+
+        Report("zones", total.m_zones, [](ZoneID zone) {
+            return fmt::format("{}", zone);
+        });
+    }
+
+    // Find ZDOs which are exact copies of another in the same zone
+    //  The most revised copy is kept
+    void FindDuplicates() {
+        ZoneScoped;
+
+        auto&& zdoManager = *ZDOManager();
+
+        std::vector<const Sector*> sectors;
+        sectors.reserve(zdoManager.m_objectsBySector.size());
+        for (auto&& pair : zdoManager.m_objectsBySector)
+            sectors.push_back(&pair.second);
+
+        const UNORDERED_SET_t<ZDO*> copies(m_copies.begin(), m_copies.end());
+
+        auto key = [](const ZDO* zdo) {
+            auto&& pos = zdo->Position();
+            auto&& rot = zdo->Rotation();
+            return std::make_tuple(zdo->GetPrefab().m_hash, pos.x, pos.y, pos.z, rot.x, rot.y, rot.z, rot.w);
+        };
+
+        std::vector<std::vector<ZDOID>> found(sectors.size());
+        m_workers.Run(sectors.size(), [&](size_t i) {
+            std::vector<const ZDO*> zdos;
+            for (auto zdo : sectors[i]->m_zdos) {
+                if (!copies.contains(zdo)
+                    && zdo->GetPrefab().AllFlagsAbsent(Prefab::Flag::SESSIONED))
+                    zdos.push_back(zdo);
+            }
+
+            std::sort(zdos.begin(), zdos.end(), [&key](const ZDO* a, const ZDO* b) {
+                return key(a) < key(b);
+            });
+
+            for (size_t j = 0; j < zdos.size(); ) {
+                auto keep = zdos[j];
+
+                size_t k = j + 1;
+                for (; k < zdos.size() && key(zdos[k]) == key(keep); k++) {
+                    if (zdos[k]->m_dataRev > keep->m_dataRev)
+                        keep = zdos[k];
+                }
+
+                for (auto l = j; l < k; l++) {
+                    if (zdos[l] != keep)
+                        found[i].push_back(zdos[l]->ID());
+                }
+
+                j = k;
+            }
+        });
+
+        for (auto&& ids : found)
+            m_duplicates.insert(m_duplicates.end(), ids.begin(), ids.end());
+    }
+
+    // Find tombstones older than allowed
+    //  Members are decoded to be read, so this runs on one thread
+    void FindExpiredTombstones() {
+        if (m_options.m_tombstoneDays <= 0)
+            return;
+
+        const auto now = Valhalla()->GetWorldTime();
+        const auto maxAge = static_cast<double>(m_options.m_tombstoneDays) * IValhalla::WORLD_TIME_LENGTH;
+
+        for (auto&& pair : ZDOManager()->m_objectsByID) {
+            auto zdo = pair.second;
+            if (zdo->GetPrefab().AllFlagsAbsent(Prefab::Flag::TOMBSTONE))
+                continue;
+
+            // Time of death is in world time ticks
+            auto ticks = zdo->GetLong(Hashes::ZDO::TombStone::TIME_OF_DEATH);
+            if (ticks <= 0)
+                continue;
+
+            auto death = duration_cast<duration<double>>(TICKS_t(ticks)).count();
+            if (now - death > maxAge)
+                m_tombstones.push_back(zdo->ID());
+        }
+    }
+
+    void Prune() {
+        auto&& zdoManager = *ZDOManager();
+
+        // Copies are not the ZDO their ID refers to, so are unindexed by hand
+        for (auto zdo : m_copies) {
+            zdoManager.RemoveFromSector(*zdo);
+            zdoManager.RemoveFromOwner(*zdo, zdo->Owner());
+            zdoManager.m_objectsByPrefab[zdo->GetPrefab().m_hash].erase(zdo);
+            zdoManager.m_pool.Delete(zdo);
+        }
+
+        for (auto&& ids : { &m_duplicates, &m_orphans, &m_tombstones }) {
+            for (auto&& zdoid : *ids)
+                zdoManager.EraseZDO(zdoid);
+        }
+    }
+
+    void Compact(const fs::path& root) {
+        auto world = WorldManager()->GetWorld();
+
+        auto source = WorldManager()->GetWorldsPath() / (world->m_name + ".db");
+        auto target = root / (world->m_name + ".db");
+
+        std::error_code err;
+        const auto sourceSize = fs::file_size(source, err);
+
+        Prune();
+
+        world->WriteFileMeta(root);
+        world->WriteFileDB(root);
+
+        const auto targetSize = fs::file_size(target, err);
+        if (err)
+            throw std::runtime_error("failed to write " + target.string());
+
+        // Replaying the journal again would bring pruned ZDOs back
+        if (fs::equivalent(target, source, err)) {
+            WorldJournal(source).Discard(std::numeric_limits<uint32_t>::max());
+            LOG_INFO(LOGGER, "Discarded world journal, as it is now part of the world");
+        }
+
+        LOG_INFO(LOGGER, "Compacted world to {} ({:.02f}mb -> {:.02f}mb)", target.string(), sourceSize / 1000000.f, targetSize / 1000000.f);
+    }
+
+public:
+    explicit WorldTool(const Options& options)
+        : m_options(options) {}
+
+    void Run() {
+        auto&& settings = VH_SETTINGS;
+        settings.worldName = m_options.m_world;
+        settings.worldSeed = m_options.m_world;
+        settings.worldModern = !m_options.m_legacy;
+        settings.zdoSyncThreads = m_options.m_threads;
+        settings.worldSaveThreads = m_options.m_threads;
+        // The world is only read, besides the compacted copy
+        settings.worldJournalInterval = 0s;
+        settings.worldPagingDelay = 0s;
+
+        auto root = WorldManager()->GetWorldsPath();
+        if (!fs::exists(root / (m_options.m_world + ".fwl"))
+            || !fs::exists(root / (m_options.m_world + ".db")))
+            throw std::runtime_error("world '" + m_options.m_world + "' not found in " + root.string());
+
+        m_workers.Start(m_options.m_threads, "WorldTool");
+
+        // Same order as the server, up to the world being loaded
+        ZDOManager()->Init();
+        RandomEventManager()->Init();
+        PrefabManager()->Init();
+        ZoneManager()->PostPrefabInit();
+        DungeonManager()->PostPrefabInit();
+        WorldManager()->PostZoneInit();
+
+        // The server starts with an empty world if loading fails
+        if (ZDOManager()->m_objectsByID.empty())
+            throw std::runtime_error("no zdos were loaded");
+
+        Gather();
+        Analyze();
+        FindDuplicates();
+        FindExpiredTombstones();
+
+        LOG_INFO(LOGGER, "Prunable zdos:");
+        LOG_INFO(LOGGER, "  {:>10} loaded again under the same id", m_copies.size());
+        LOG_INFO(LOGGER, "  {:>10} duplicated in place", m_duplicates.size());
+        LOG_INFO(LOGGER, "  {:>10} sessioned or outside of the world", m_orphans.size());
+        LOG_INFO(LOGGER, "  {:>10} expired tombstones", m_tombstones.size());
+
+        if (m_options.m_compact)
+            Compact(*m_options.m_compact);
+
+        WorldManager()->Uninit();
+        m_workers.Stop();
+    }
+};
+
+static WorldTool::Options ParseOptions(int argc, char** argv) {
+    WorldTool::Options options;
+
+    auto number = [&](int& i) {
+        if (++i >= argc)
+            throw std::runtime_error(std::string(argv[i - 1]) + " expects a value");
+
+        int value;
+        std::string_view arg(argv[i]);
+        auto result = std::from_chars(arg.data(), arg.data() + arg.size(), value);
+        if (result.ec != std::errc() || result.ptr != arg.data() + arg.size() || value < 0)
+            throw std::runtime_error(std::string(argv[i - 1]) + " expects a positive number");
+        return value;
+    };
+
+    for (int i = 1; i < argc; i++) {
+        std::string_view arg(argv[i]);
+        if (arg == "--threads")
+            options.m_threads = number(i);
+        else if (arg == "--top")
+            options.m_top = number(i);
+        else if (arg == "--tombstone-days")
+            options.m_tombstoneDays = number(i);
+        else if (arg == "--legacy")
+            options.m_legacy = true;
+        else if (arg == "--compact") {
+            if (++i >= argc)
+                throw std::runtime_error("--compact expects a directory");
+            // Relative to where the tool was run, rather than the data directory
+            options.m_compact = fs::absolute(argv[i]);
+        }
+        else if (arg.starts_with("--") || !options.m_world.empty())
+            throw std::runtime_error("unexpected argument " + std::string(arg));
+        else
+            options.m_world = arg;
+    }
+
+    if (options.m_world.empty())
+        throw std::runtime_error("no world given");
+
+    return options;
+}
+
+int main(int argc, char** argv) {
+    WorldTool::Options options;
+    try {
+        options = ParseOptions(argc, argv);
+    }
+    catch (const std::exception& e) {
+        std::fprintf(stderr, "%s\n%s", e.what(), USAGE);
+        return 1;
+    }
+
+    fs::current_path("./data/");
+
+    {
+        quill::Config cfg;
+        cfg.enable_console_colours = true;
+
+        auto&& colours = quill::ConsoleColours();
+        colours.set_default_colours();
+        cfg.default_handlers.push_back(quill::stdout_handler("colourout", std::move(colours)));
+
+        quill::configure(cfg);
+        quill::start();
+
+        LOGGER = quill::get_logger();
+        LOGGER->set_log_level(quill::LogLevel::Info);
+    }
+
+    try {
+        WorldTool(options).Run();
+    }
+    catch (const std::exception& e) {
+        LOG_ERROR(LOGGER, "{}", e.what());
+        return 1;
+    }
+
+    return 0;
+}
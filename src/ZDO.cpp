@@ -23,6 +23,26 @@ ZDO::ZDO(ZDOID id, Vector3f pos)
     //m_rev.m_ticksCreated = Valhalla()->GetWorldTicks();
 }
 
+const ZDO::StringEntry* ZDO::Intern(std::string value) {
+    auto lock = ZDOManager()->LockInternPools();
+    return ZDOManager()->m_strings.Acquire(std::move(value), VH_SETTINGS.zdoInternMembers);
+}
+
+const ZDO::BytesEntry* ZDO::Intern(BYTES_t value) {
+    auto lock = ZDOManager()->LockInternPools();
+    return ZDOManager()->m_bytes.Acquire(std::move(value), VH_SETTINGS.zdoInternMembers);
+}
+
+void ZDO::Release(const StringEntry* entry) {
+    auto lock = ZDOManager()->LockInternPools();
+    ZDOManager()->m_strings.Release(entry);
+}
+
+void ZDO::Release(const BytesEntry* entry) {
+    auto lock = ZDOManager()->LockInternPools();
+    ZDOManager()->m_bytes.Release(entry);
+}
+
 //ZDO::ZDO(const ZDOID& id, const Vector3f& pos, HASH_t prefab)
 //    : m_id(id), m_pos(pos), m_prefab(PrefabManager()->RequirePrefab(prefab))
 //{
@@ -50,17 +70,17 @@ void ZDO::Save(DataWriter& pkg) const {
     pkg.Write(this->m_pos);
     pkg.Write(this->m_rotation);
     
+    // Untouched members are copied back out as they were loaded
+    if (m_members.IsEncoded()) {
+        pkg.WriteRaw(m_members.GetRecord());
+        return;
+    }
+
     // Save uses 2 bytes for counts (char in c# is 2 bytes..)
-    _TryWriteType<float,            char16_t>(pkg);
-    _TryWriteType<Vector3f,         char16_t>(pkg);
-    _TryWriteType<Quaternion,       char16_t>(pkg);
-    _TryWriteType<int32_t,          char16_t>(pkg);
-    _TryWriteType<int64_t,          char16_t>(pkg);
-    _TryWriteType<std::string,      char16_t>(pkg);
-    _TryWriteType<BYTES_t,          char16_t>(pkg);
+    _WriteMembers<char16_t>(pkg);
 }
 
-bool ZDO::Load(DataReader& pkg, int32_t worldVersion) {
+bool ZDO::Load(DataReader& pkg, int32_t worldVersion, bool lazy) {
     this->SetOwnerRevision(pkg.Read<uint32_t>());   // ownerRev; TODO redundant?
     this->m_dataRev = pkg.Read<uint32_t>();   // dataRev; TODO redundant?
     pkg.Read<bool>();       // persistent
@@ -89,6 +109,16 @@ bool ZDO::Load(DataReader& pkg, int32_t worldVersion) {
     this->m_pos = pkg.Read<Vector3f>();
     this->m_rotation = pkg.Read<Quaternion>();
 
+    // Members are left encoded if they are saved the same way they were loaded
+    //  Time created is held as a member, so those prefabs are decoded upfront
+    if (lazy && worldVersion >= 27
+        && GetPrefab().AllFlagsAbsent(Prefab::Flag::TERRAIN_MODIFIER | Prefab::Flag::DUNGEON))
+    {
+        m_members.SetRecord(BYTE_VIEW_t(pkg.data() + pkg.Position(), pkg.size() - pkg.Position()));
+        pkg.SetPos(pkg.size());
+        return modern;
+    }
+
     _TryReadType<float,         char16_t>(pkg);
     _TryReadType<Vector3f,      char16_t>(pkg);
     _TryReadType<Quaternion,    char16_t>(pkg);
@@ -102,7 +132,9 @@ bool ZDO::Load(DataReader& pkg, int32_t worldVersion) {
     if (worldVersion < 17)
         this->m_prefab = PrefabManager()->RequirePrefab(GetInt("prefab"));
 
-    SetTimeCreated(timeCreated);
+    // Loading may run across threads, so the ZDO is not revised
+    if (GetPrefab().AnyFlagsPresent(Prefab::Flag::TERRAIN_MODIFIER | Prefab::Flag::DUNGEON))
+        _Set(HASH_TIME_CREATED, timeCreated.count());
 
     return modern;
 }
@@ -112,6 +144,52 @@ bool ZDO::Load(DataReader& pkg, int32_t worldVersion) {
 
 // ZDO specific-methods
 
+void ZDO::_DecodeRecord() {
+    DataReader reader(m_members.TakeRecord());
+
+    _TryReadType<float,         char16_t>(reader);
+    _TryReadType<Vector3f,      char16_t>(reader);
+    _TryReadType<Quaternion,    char16_t>(reader);
+    _TryReadType<int32_t,       char16_t>(reader);
+    _TryReadType<int64_t,       char16_t>(reader);
+    _TryReadType<std::string,   char16_t>(reader);
+    _TryReadType<BYTES_t,       char16_t>(reader);
+}
+
+void ZDO::_SetOwner(OWNER_t owner) {
+    if (!(owner >= -2147483647LL && owner <= 4294967293LL)) {
+        // Ensure filler complement bits are all the same (full negative or full positive)
+        //if ((owner < 0 && (static_cast<uint64_t>(owner) & ~ENCODED_OWNER_MASK) != ~ENCODED_OWNER_MASK)
+            //|| (owner >= 0 && (static_cast<uint64_t>(owner) & ~ENCODED_OWNER_MASK) == ~ENCODED_OWNER_MASK))
+        throw std::runtime_error("OWNER_t unexpected encoding (client Utils.GenerateUID() differs?)");
+    }
+
+    const auto previous = Owner();
+
+    // Zero out the owner bytes (including sign)
+    this->m_encoded &= ~ENCODED_OWNER_MASK;
+    assert(Owner() == 0);
+
+    // Set the owner bytes
+    //  ignore the 2's complement middle bytes
+    this->m_encoded |= (static_cast<uint64_t>(owner) & ENCODED_OWNER_MASK);
+
+    assert(Owner() == owner);
+
+    if (previous != owner)
+        ZDOManager()->ReindexOwner(*this, previous);
+}
+
+void ZDO::Revise() {
+    m_dataRev++;
+    ZDOManager()->MarkDirty(*this);
+}
+
+void ZDO::ReviseOwner() {
+    this->m_encoded += 0b0000000000000000000000000000000100000000000000000000000000000000ULL;
+    ZDOManager()->MarkDirty(*this);
+}
+
 void ZDO::SetPosition(const Vector3f& pos) {
     if (m_pos != pos) {
         ZDOManager()->InvalidateZDOZone(*this);
@@ -130,6 +208,8 @@ ZoneID ZDO::GetZone() const {
 void ZDO::Serialize(DataWriter& pkg) const {
     static_assert(sizeof(VConstants::PGW) == 4);
 
+    _Decode();
+
     auto&& prefab = GetPrefab();
     
     pkg.Write(prefab.AnyFlagsAbsent(Prefab::Flag::SESSIONED));
@@ -157,17 +237,14 @@ void ZDO::Serialize(DataWriter& pkg) const {
     }
     pkg.Write(static_cast<int32_t>(ordinalMask));
 
-    _TryWriteType<float,            uint8_t>(pkg);
-    _TryWriteType<Vector3f,         uint8_t>(pkg);
-    _TryWriteType<Quaternion,       uint8_t>(pkg);
-    _TryWriteType<int32_t,          uint8_t>(pkg);
-    _TryWriteType<int64_t,          uint8_t>(pkg);
-    _TryWriteType<std::string,      uint8_t>(pkg);
-    _TryWriteType<BYTES_t,          uint8_t>(pkg);
+    _WriteMembers<uint8_t>(pkg);
 }
 
 void ZDO::Deserialize(DataReader& pkg) {
     static_assert(sizeof(Prefab::Type) == 1);
+
+    // Received members are merged into the existing ones
+    _Decode();
     
     pkg.Read<bool>();       // m_persistent
     pkg.Read<bool>();       // m_distant
@@ -189,7 +266,8 @@ void ZDO::Deserialize(DataReader& pkg) {
         ordinalMask |= GetOrdinalMask<BYTES_t>(); // reassign the array bit to 5th
     }
 
-    this->SetOrdinalMask(ordinalMask);
+    // Members of types the peer did not send are kept, so stay in the mask
+    this->SetOrdinalMask(GetOrdinalMask() | ordinalMask);
 
     // double check this; 
     if (ordinalMask & GetOrdinalMask<float>())
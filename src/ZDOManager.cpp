@@ -14,6 +14,43 @@ IZDOManager* ZDOManager() {
 	return ZDO_MANAGER.get();
 }
 
+// Zone radius in which distant ZDOs are synced
+static constexpr int SYNC_DISTANT_RANGE = IZoneManager::NEAR_ACTIVE_AREA + IZoneManager::DISTANT_ACTIVE_AREA;
+
+// Smallest possible size of a ZDO within a ZDOData packet
+//	Used to bound how many ZDOs can fit in a send
+static constexpr size_t MIN_SYNC_ZDO_SIZE = 80;
+
+// Seconds after which an unused ZDO payload is dropped
+static constexpr float PAYLOAD_EXPIRY = 60;
+
+// Most recent changes kept per zone for peers to catch up on
+static constexpr size_t MAX_ZONE_JOURNAL = 256;
+
+// ZDOs serialized together by a single save worker
+static constexpr size_t SAVE_SHARD_SIZE = 4096;
+
+// ZDOs parsed together by a single load worker
+static constexpr size_t LOAD_SHARD_SIZE = 4096;
+
+// Zone radius around peers which is kept in memory
+//	One beyond the synced area so zones are resident before peers see them
+static constexpr int PAGING_RANGE = SYNC_DISTANT_RANGE + 1;
+
+// Remove a ZDO from an unordered list by moving the last ZDO into its place
+static void SwapRemove(std::vector<ZDO*>& zdos, ZDO* zdo) {
+	auto&& find = std::find(zdos.begin(), zdos.end(), zdo);
+	assert(find != zdos.end());
+
+	*find = zdos.back();
+	zdos.pop_back();
+}
+
+// Chebyshev distance between zones
+static int ZoneDistance(ZoneID a, ZoneID b) {
+	return std::max(std::abs(a.x - b.x), std::abs(a.y - b.y));
+}
+
 
 
 void IZDOManager::Init() {
@@ -35,6 +72,8 @@ void IZDOManager::Init() {
 			peer->ForceSendZDO(id);
 		}
 	);
+
+	m_syncWorkers.Start(VH_SETTINGS.zdoSyncThreads, "ZDOSync");
 }
 
 void IZDOManager::Update() {
@@ -42,6 +81,8 @@ void IZDOManager::Update() {
 
 	PERIODIC_NOW(3min, {
 		LOG_INFO(LOGGER, "Currently {} zdos (~{:0.02f}mb)", m_objectsByID.size(), (GetTotalZDOAlloc() / 1000000.f));
+		LOG_INFO(LOGGER, "Shared zdo values: {} strings, {} byte arrays", m_strings.size(), m_bytes.size());
+		LOG_INFO(LOGGER, "Remembering {} destroyed zdos", m_erasedZDOs.size());
 		//VLOG(1) << "ZDO members (sum: " << GetSumZDOMembers()
 			//<< ", mean: " << GetMeanZDOMembers()
 			//<< ", stdev: " << GetStDevZDOMembers()
@@ -51,34 +92,46 @@ void IZDOManager::Update() {
 
 	auto&& peers = NetManager()->GetPeers();
 	
-#ifdef VH_OPTION_ENABLE_CAPTURE
 	// Occasionally release ZDOs
 	PERIODIC_NOW(VH_SETTINGS.zdoAssignInterval, {
+		std::vector<Peer*> assigning;
 		for (auto&& peer : peers) {
-			if (
-				(VH_SETTINGS.packetMode != PacketMode::PLAYBACK
-				|| std::dynamic_pointer_cast<ReplaySocket>(peer->m_socket)) 
-				&& !peer->m_gatedPlaythrough)
-			AssignOrReleaseZDOs(*peer);
-		}
-	});
-#else // macro expansion screwed this up
-	PERIODIC_NOW(VH_SETTINGS.zdoAssignInterval, {
-		for (auto&& peer : peers) {
-			if (!peer->m_gatedPlaythrough)
-				AssignOrReleaseZDOs(*peer);
+			if (CanAssignZDOs(*peer))
+				assigning.push_back(peer);
 		}
+		AssignOrReleaseZDOs(assigning);
 	});
-#endif
 
 	// Send ZDOS:
 	PERIODIC_NOW(VH_SETTINGS.zdoSendInterval, {
-		for (auto&& peer : peers) {
-			SendZDOs(*peer, false);
-		}
+		FlushDirtyZDOs();
+		SendZDOs(peers);
 	});
 	
 
+	// Evict zones which peers have left
+	if (m_pages) {
+		PERIODIC_NOW(1s, {
+			UpdatePaging(peers);
+		});
+	}
+
+	// Forget ZDOs which were destroyed long ago
+	PERIODIC_NOW(1min, {
+		m_erasedZDOs.Prune(Valhalla()->Time());
+	});
+
+	// Forget payloads of ZDOs which are no longer being sent
+	PERIODIC_NOW(1min, {
+		const auto expiry = Valhalla()->Time() - PAYLOAD_EXPIRY;
+		for (auto&& itr = m_payloads.begin(); itr != m_payloads.end(); ) {
+			if (itr->second.m_lastUsed < expiry)
+				itr = m_payloads.erase(itr);
+			else
+				++itr;
+		}
+	});
+
 	if (!m_destroySendList.empty()) {
 
 		// TODO make a member variable?
@@ -93,23 +146,104 @@ void IZDOManager::Update() {
 }
 
 
+void IZDOManager::Sector::Insert(ZDO& zdo) {
+	assert(std::find(m_zdos.begin(), m_zdos.end(), &zdo) == m_zdos.end());
+
+	m_zdos.push_back(&zdo);
+	m_positions.push_back(zdo.m_pos);
+	m_zdosByPrefab[zdo.GetPrefab().m_hash].push_back(&zdo);
+
+	for (size_t i = 0; i < BUCKETED_FLAGS.size(); i++) {
+		if (zdo.GetPrefab().AllFlagsPresent(BUCKETED_FLAGS[i]))
+			m_zdosByFlag[i].push_back(&zdo);
+	}
+}
+
+bool IZDOManager::Sector::Erase(ZDO& zdo) {
+	auto&& find = std::find(m_zdos.begin(), m_zdos.end(), &zdo);
+	if (find == m_zdos.end())
+		return false;
+
+	auto index = std::distance(m_zdos.begin(), find);
+
+	// Move the last element into the hole to keep storage packed
+	m_zdos[index] = m_zdos.back();
+	m_positions[index] = m_positions.back();
+	m_zdos.pop_back();
+	m_positions.pop_back();
+
+	auto&& bucket = m_zdosByPrefab.find(zdo.GetPrefab().m_hash);
+	assert(bucket != m_zdosByPrefab.end());
+
+	SwapRemove(bucket->second, &zdo);
+	if (bucket->second.empty())
+		m_zdosByPrefab.erase(bucket);
+
+	for (size_t i = 0; i < BUCKETED_FLAGS.size(); i++) {
+		if (zdo.GetPrefab().AllFlagsPresent(BUCKETED_FLAGS[i]))
+			SwapRemove(m_zdosByFlag[i], &zdo);
+	}
+
+	return true;
+}
+
+IZDOManager::Sector* IZDOManager::GetSector(ZoneID zone) {
+	int num = SectorToIndex(zone);
+	if (num != -1) {
+		auto&& find = m_objectsBySector.find(num);
+		if (find != m_objectsBySector.end())
+			return &find->second;
+	}
+	return nullptr;
+}
+
 bool IZDOManager::AddZDOToZone(ZDO& zdo) {
 	int num = SectorToIndex(zdo.GetZone());
 	if (num != -1) {
-		auto&& pair = m_objectsBySector[num].insert(&zdo);
-		assert(pair.second);
+		// The rest of the zone is brought back on the next paging update
+		if (m_pages && m_pages->Contains(zdo.GetZone()))
+			m_pagesWanted.insert(zdo.GetZone());
+
+		m_objectsBySector[num].Insert(zdo);
+		MarkDirty(zdo);
 		return true;
 	}
 	return false;
 }
 
+std::unique_lock<std::mutex> IZDOManager::LockInternPools() {
+	if (m_parallelLoad)
+		return std::unique_lock<std::mutex>(m_internMux);
+	return {};
+}
+
 void IZDOManager::RemoveFromSector(ZDO& zdo) {
-	int num = SectorToIndex(zdo.GetZone());
-	if (num != -1) {
-		m_objectsBySector[num].erase(&zdo);
+	if (auto sector = GetSector(zdo.GetZone()))
+		sector->Erase(zdo);
+}
+
+void IZDOManager::AddZDOToOwner(ZDO& zdo) {
+	if (zdo.HasOwner() || zdo.GetPrefab().AllFlagsPresent(Prefab::Flag::SESSIONED))
+		m_objectsByOwner[zdo.Owner()].insert(&zdo);
+}
+
+void IZDOManager::RemoveFromOwner(ZDO& zdo, OWNER_t owner) {
+	auto&& find = m_objectsByOwner.find(owner);
+	if (find != m_objectsByOwner.end()) {
+		find->second.erase(&zdo);
+		if (find->second.empty())
+			m_objectsByOwner.erase(find);
 	}
 }
 
+void IZDOManager::ReindexOwner(ZDO& zdo, OWNER_t previous) {
+	if (GetZDO(zdo.ID()) != &zdo)
+		return;
+
+	RemoveFromOwner(zdo, previous);
+	AddZDOToOwner(zdo);
+}
+
 void IZDOManager::InvalidateZDOZone(ZDO& zdo) {
 	RemoveFromSector(zdo);
 
@@ -120,46 +254,103 @@ void IZDOManager::InvalidateZDOZone(ZDO& zdo) {
 
 
 
-void IZDOManager::Save(DataWriter& writer) {
-	//pkg.Write(Valhalla()->ID());
-	writer.Write<OWNER_t>(0);
-	writer.Write(m_nextUid);
-	
+IZDOManager::SaveSnapshot IZDOManager::Snapshot() {
+	ZoneScoped;
+
+	// A zone must not be saved both from memory and the paging file
+	PageInWanted();
+
+	SaveSnapshot snapshot;
+	snapshot.m_nextUid = m_nextUid;
+
+	// Copying only touches the ZDOs themselves and bumps the shared
+	//	value refcounts, which is much cheaper than serializing them
+	snapshot.m_zdos.reserve(m_objectsByID.size());
+	for (auto&& pair : m_objectsBySector) {
+		for (auto zdo : pair.second.m_zdos) {
+			if (zdo->m_prefab.get().AnyFlagsAbsent(Prefab::Flag::SESSIONED))
+				snapshot.m_zdos.push_back(*zdo);
+		}
+	}
+
+	if (m_pages) {
+		snapshot.m_pagePath = m_pages->Path();
+		snapshot.m_pages = m_pages->Chunks();
+		snapshot.m_pagePin = m_pages->Pin();
+		snapshot.m_pagedCount = m_pages->size();
+	}
+
+	return snapshot;
+}
+
+void IZDOManager::Save(WorkerPool& workers, const SaveSnapshot& snapshot, const std::function<void(const BYTES_t&)>& sink) {
+	ZoneScoped;
+
+	BYTES_t bytes;
 	{
-		// Write zdos (persistent)
-		const auto start = writer.Position();
+		DataWriter writer(bytes);
 
-		int32_t count = 0;
-		writer.Write(count);
+		//pkg.Write(Valhalla()->ID());
+		writer.Write<OWNER_t>(0);
+		writer.Write(snapshot.m_nextUid);
+		writer.Write<int32_t>(snapshot.m_zdos.size() + snapshot.m_pagedCount);
+	}
+	sink(bytes);
 
-		{
-			//NetPackage zdoPkg;
-			for (auto&& sectorObjects : m_objectsBySector) {
-				for (auto zdo : sectorObjects) {
-					if (zdo->m_prefab.get().AnyFlagsAbsent(Prefab::Flag::SESSIONED)) {
-						writer.Write(zdo->ID());
-						writer.SubWrite([&zdo](DataWriter& writer) {
-							zdo->Save(writer);
-						});
-						count++;
-					}
-				}
+	// Write zdos (persistent)
+	//	Shards are done in rounds so only a few are buffered at once
+	const size_t shardCount = (snapshot.m_zdos.size() + SAVE_SHARD_SIZE - 1) / SAVE_SHARD_SIZE;
+	const size_t roundSize = (workers.size() + 1) * 4;
+
+	std::vector<BYTES_t> shards(std::min(shardCount, roundSize));
+
+	for (size_t first = 0; first < shardCount; first += roundSize) {
+		const size_t count = std::min(roundSize, shardCount - first);
+
+		workers.Run(count, [&](size_t i) {
+			auto&& shard = shards[i];
+			shard.clear();
+
+			DataWriter writer(shard);
+
+			const auto begin = (first + i) * SAVE_SHARD_SIZE;
+			const auto end = std::min(begin + SAVE_SHARD_SIZE, snapshot.m_zdos.size());
+			for (auto j = begin; j < end; j++) {
+				auto&& zdo = snapshot.m_zdos[j];
+
+				writer.Write(zdo.ID());
+				writer.SubWrite([&zdo](DataWriter& writer) {
+					zdo.Save(writer);
+				});
 			}
-		}
+		});
+
+		for (size_t i = 0; i < count; i++)
+			sink(shards[i]);
+	}
+
+	// Paged zones are already serialized, so are only decompressed
+	if (!snapshot.m_pages.empty()) {
+		std::unique_ptr<FILE, decltype(&std::fclose)> file(
+			std::fopen(snapshot.m_pagePath.string().c_str(), "rb"), &std::fclose);
+		if (!file)
+			throw std::runtime_error("failed to open " + snapshot.m_pagePath.string());
 
-		//const auto end = pkg.Position();
-		writer.SetPos(start);
-		writer.Write(count);
-		//pkg.SetPos(end);
-		writer.SetPos(writer.size());
+		for (auto&& chunk : snapshot.m_pages)
+			sink(ZoneStore::Read(file.get(), chunk));
 	}
 
-	writer.Write<int32_t>(0);
+	bytes.clear();
+	{
+		DataWriter writer(bytes);
+		writer.Write<int32_t>(0);
+	}
+	sink(bytes);
 }
 
 
 
-void IZDOManager::Load(DataReader& reader, int version) {
+void IZDOManager::Load(DataReader& reader, int version, std::unique_ptr<MappedFile> source) {
 	reader.Read<OWNER_t>(); // skip server id
 	m_nextUid = reader.Read<uint32_t>();
 	const auto count = reader.Read<int32_t>();
@@ -168,12 +359,95 @@ void IZDOManager::Load(DataReader& reader, int version) {
 
 	int purgeCount = 0;
 
-	for (int i = 0; i < count; i++) {
-		auto zdo = std::make_unique<ZDO>();
-		zdo->m_id = reader.Read<ZDOID>();
-		auto zdoReader = reader.Read<DataReader>();
+	// Records of a previous source may still be referenced
+	const bool lazy = source && !m_source;
+	if (lazy)
+		m_source = std::move(source);
+
+	m_pool.Reserve(count);
+	m_objectsByID.reserve(m_objectsByID.size() + count);
+
+	struct Record {
+		ZDO* m_zdo;
+		BYTE_VIEW_t m_bytes;
+		bool m_keep = false;
+		int m_sector = -1;
+	};
+
+	// Find the bounds of every record up front so they can be parsed in parallel
+	std::vector<Record> records;
+	records.reserve(count);
+	try {
+		for (int i = 0; i < count; i++) {
+			auto id = reader.Read<ZDOID>();
+			auto bytes = reader.Read<BYTE_VIEW_t>();
+
+			auto zdo = m_pool.New();
+			zdo->m_id = id;
+
+			auto&& record = records.emplace_back();
+			record.m_zdo = zdo;
+			record.m_bytes = bytes;
+		}
+
+		ZoneScopedN("ParseZDOs");
+
+		const size_t shardCount = (records.size() + LOAD_SHARD_SIZE - 1) / LOAD_SHARD_SIZE;
+		std::vector<std::exception_ptr> errors(shardCount);
 
-		bool modern = zdo->Load(zdoReader, version);
+		m_parallelLoad = true;
+		m_syncWorkers.Run(shardCount, [&](size_t i) {
+			const auto begin = i * LOAD_SHARD_SIZE;
+			const auto end = std::min(begin + LOAD_SHARD_SIZE, records.size());
+			try {
+				for (auto j = begin; j < end; j++) {
+					auto&& record = records[j];
+					DataReader zdoReader(record.m_bytes);
+					record.m_keep = record.m_zdo->Load(zdoReader, version, lazy) || !VH_SETTINGS.worldModern;
+					record.m_sector = SectorToIndex(record.m_zdo->GetZone());
+				}
+			}
+			catch (...) {
+				errors[i] = std::current_exception();
+			}
+		});
+		m_parallelLoad = false;
+
+		// Report the first bad record, as a serial load would have
+		for (auto&& error : errors) {
+			if (error)
+				std::rethrow_exception(error);
+		}
+	}
+	catch (...) {
+		// None of the records were added yet, so release them all
+		m_parallelLoad = false;
+		for (auto&& record : records)
+			m_pool.Delete(record.m_zdo);
+
+		if (lazy)
+			m_source.reset();
+		throw;
+	}
+
+	// Size the sectors once rather than growing them ZDO by ZDO
+	{
+		UNORDERED_MAP_t<int, size_t> sectorCounts;
+		for (auto&& record : records) {
+			if (record.m_keep && record.m_sector != -1)
+				sectorCounts[record.m_sector]++;
+		}
+
+		m_objectsBySector.reserve(m_objectsBySector.size() + sectorCounts.size());
+		for (auto&& pair : sectorCounts) {
+			auto&& sector = m_objectsBySector[pair.first];
+			sector.m_zdos.reserve(sector.m_zdos.size() + pair.second);
+			sector.m_positions.reserve(sector.m_positions.size() + pair.second);
+		}
+	}
+
+	for (auto&& record : records) {
+		auto zdo = record.m_zdo;
 
 		// TODO redundant?
 		//	thinking about it, this might be for very old versions where the ID is not normal
@@ -184,21 +458,13 @@ void IZDOManager::Load(DataReader& reader, int version) {
 		//	m_nextUid = zdo->ID().m_id + 1;
 		//}
 
-		if (modern || !VH_SETTINGS.worldModern) {
-			auto&& prefab = zdo->GetPrefab();
-
-			AddZDOToZone(*zdo.get());
-			m_objectsByPrefab[prefab.m_hash].insert(zdo.get());
-
-			if (prefab.AllFlagsPresent(Prefab::Flag::DUNGEON)) {
-				// Only add real sky dungeon
-				if (zdo->Position().y > 4000)
-					DungeonManager()->m_dungeonInstances.push_back(zdo->ID());
-			}
-
-			m_objectsByID[zdo->ID()] = std::move(zdo);
+		if (record.m_keep) {
+			AddLoadedZDO(*zdo);
+		}
+		else {
+			m_pool.Delete(zdo);
+			purgeCount++;
 		}
-		else purgeCount++;
 	}
 
 	auto deadCount = reader.Read<int32_t>();
@@ -207,12 +473,248 @@ void IZDOManager::Load(DataReader& reader, int version) {
 		TICKS_t(reader.Read<int64_t>());
 	}
 
+	// Peers gather loaded ZDOs on their first sync
+	m_dirtyZDOs.clear();
+
 	LOG_INFO(LOGGER, "Loaded {} zdos", m_objectsByID.size());
 	if (purgeCount) {
 		LOG_INFO(LOGGER, "Purged {} old zdos", purgeCount);
 	}
 }
 
+void IZDOManager::AddLoadedZDO(ZDO& zdo) {
+	auto&& prefab = zdo.GetPrefab();
+
+	AddZDOToZone(zdo);
+	AddZDOToOwner(zdo);
+	m_objectsByPrefab[prefab.m_hash].insert(&zdo);
+
+	if (prefab.AllFlagsPresent(Prefab::Flag::DUNGEON)) {
+		// Only add real sky dungeon
+		//	A replayed dungeon may already be known
+		auto&& dungeons = DungeonManager()->m_dungeonInstances;
+		if (zdo.Position().y > 4000
+			&& std::find(dungeons.begin(), dungeons.end(), zdo.ID()) == dungeons.end())
+			dungeons.push_back(zdo.ID());
+	}
+
+	m_objectsByID[zdo.ID()] = &zdo;
+}
+
+void IZDOManager::TrackChanges() {
+	m_unsavedZDOs.clear();
+	m_unsavedDestroys.clear();
+	m_trackChanges = true;
+}
+
+void IZDOManager::SaveChanges(DataWriter& writer) {
+	ZoneScoped;
+
+	// Gather the latest modifications
+	FlushDirtyZDOs();
+
+	std::vector<ZDO*> changed;
+	changed.reserve(m_unsavedZDOs.size());
+	for (auto&& zdoid : m_unsavedZDOs) {
+		auto zdo = GetZDO(zdoid);
+		if (zdo && zdo->GetPrefab().AnyFlagsAbsent(Prefab::Flag::SESSIONED))
+			changed.push_back(zdo);
+	}
+
+	writer.Write(m_nextUid);
+
+	writer.Write<int32_t>(changed.size());
+	for (auto zdo : changed) {
+		writer.Write(zdo->ID());
+		writer.SubWrite([zdo](DataWriter& writer) {
+			zdo->Save(writer);
+		});
+	}
+
+	writer.Write(m_unsavedDestroys);
+
+	m_unsavedZDOs.clear();
+	m_unsavedDestroys.clear();
+}
+
+void IZDOManager::LoadChanges(DataReader& reader, int version) {
+	m_nextUid = std::max(m_nextUid, reader.Read<uint32_t>());
+
+	const auto count = reader.Read<int32_t>();
+	for (int i = 0; i < count; i++) {
+		auto zdoid = reader.Read<ZDOID>();
+		auto zdoReader = reader.Read<DataReader>();
+
+		// Replace the previously loaded state
+		EraseZDO(zdoid);
+
+		auto zdo = m_pool.New();
+		zdo->m_id = zdoid;
+		zdo->Load(zdoReader, version);
+		AddLoadedZDO(*zdo);
+	}
+
+	reader.AsEach([this](ZDOID zdoid) {
+		EraseZDO(zdoid);
+	});
+
+	// Replayed erasures are not destructions peers could be behind on
+	m_erasedZDOs.Clear();
+	m_dirtyZDOs.clear();
+}
+
+void IZDOManager::StartPaging(fs::path path) {
+	m_pages = std::make_unique<ZoneStore>(std::move(path));
+
+	LOG_INFO(LOGGER, "Paging out zones after {}s without peers", VH_SETTINGS.worldPagingDelay.count());
+}
+
+bool IZDOManager::CanPageOut(const ZDO& zdo) const {
+	auto&& prefab = zdo.GetPrefab();
+
+	// Dungeons, players and portals are looked up world-wide
+	//	Owned and changed ZDOs are still in use
+	return prefab.AllFlagsAbsent(Prefab::Flag::SESSIONED | Prefab::Flag::DUNGEON | Prefab::Flag::PLAYER | Prefab::Flag::TOMBSTONE)
+		&& prefab.m_hash != Hashes::Object::portal
+		&& prefab.m_hash != Hashes::Object::portal_wood
+		&& !zdo.HasOwner()
+		&& !m_dirtyZDOs.contains(zdo.ID())
+		&& !m_unsavedZDOs.contains(zdo.ID());
+}
+
+void IZDOManager::PageOutZone(ZoneID zone) {
+	ZoneScoped;
+
+	auto sector = GetSector(zone);
+	if (!sector)
+		return;
+
+	std::vector<ZDO*> evicted;
+	for (auto zdo : sector->m_zdos) {
+		if (CanPageOut(*zdo))
+			evicted.push_back(zdo);
+	}
+
+	if (evicted.empty())
+		return;
+
+	// Chunks hold records as laid out in the world db
+	//	ZDOs evicted earlier stay in the same chunk
+	BYTES_t records;
+	uint32_t count = 0;
+	if (auto previous = m_pages->Take(zone))
+		std::tie(records, count) = std::move(*previous);
+
+	{
+		DataWriter writer(records, records.size());
+		for (auto zdo : evicted) {
+			writer.Write(zdo->ID());
+			writer.SubWrite([zdo](DataWriter& writer) {
+				zdo->Save(writer);
+			});
+		}
+	}
+
+	count += evicted.size();
+	m_pages->Write(zone, records, count);
+
+	for (auto zdo : evicted)
+		UnloadZDO(m_objectsByID.find(zdo->ID()));
+
+	m_pagesWanted.erase(zone);
+}
+
+void IZDOManager::PageInZone(ZoneID zone) {
+	ZoneScoped;
+
+	auto page = m_pages->Take(zone);
+	if (!page)
+		return;
+
+	// Changes made before are journaled as usual
+	FlushDirtyZDOs();
+
+	DataReader reader(page->first);
+	for (uint32_t i = 0; i < page->second; i++) {
+		auto zdoid = reader.Read<ZDOID>();
+		auto zdoReader = reader.Read<DataReader>();
+
+		// A peer brought its own copy back first
+		if (m_objectsByID.contains(zdoid))
+			continue;
+
+		auto zdo = m_pool.New();
+		zdo->m_id = zdoid;
+		zdo->Load(zdoReader, VConstants::WORLD);
+		AddLoadedZDO(*zdo);
+	}
+
+	// Peers are told of the ZDOs through the zone journal,
+	//	but they are unchanged since written to the world journal
+	auto trackChanges = std::exchange(m_trackChanges, false);
+	FlushDirtyZDOs();
+	m_trackChanges = trackChanges;
+
+	m_pagesWanted.erase(zone);
+}
+
+void IZDOManager::PageInWanted() {
+	if (!m_pages)
+		return;
+
+	// Paging in erases from the set, so iterate a detached copy
+	auto wanted = std::exchange(m_pagesWanted, {});
+	for (auto&& zone : wanted)
+		PageInZone(zone);
+}
+
+void IZDOManager::UpdatePaging(const std::vector<Peer*>& peers) {
+	ZoneScoped;
+
+	PageInWanted();
+
+	const auto now = Valhalla()->Time();
+
+	for (auto&& peer : peers) {
+		auto center = IZoneManager::WorldToZonePos(peer->m_pos);
+		for (auto z = center.y - PAGING_RANGE; z <= center.y + PAGING_RANGE; z++) {
+			for (auto x = center.x - PAGING_RANGE; x <= center.x + PAGING_RANGE; x++) {
+				ZoneID zone(x, z);
+				if (m_pages->Contains(zone))
+					PageInZone(zone);
+
+				m_zonesLastNeeded[zone] = now;
+			}
+		}
+	}
+
+	const auto delay = static_cast<float>(VH_SETTINGS.worldPagingDelay.count());
+
+	// Zones are given the full delay from when they are first seen
+	std::vector<ZoneID> cold;
+	for (auto&& pair : m_objectsBySector) {
+		auto&& sector = pair.second;
+		if (sector.empty())
+			continue;
+
+		auto zone = sector.m_zdos.front()->GetZone();
+		auto&& lastNeeded = m_zonesLastNeeded.try_emplace(zone, now).first->second;
+		if (now - lastNeeded > delay)
+			cold.push_back(zone);
+	}
+
+	for (auto&& zone : cold) {
+		PageOutZone(zone);
+		m_zonesLastNeeded.erase(zone);
+	}
+
+	m_pages->Compact();
+
+	PERIODIC_NOW(3min, {
+		LOG_INFO(LOGGER, "Paged out {} zdos (~{:0.02f}mb on disk)", m_pages->size(), m_pages->GetFileSize() / 1000000.f);
+	});
+}
+
 ZDO& IZDOManager::Instantiate(Vector3f position) {
 	ZDOID zdoid = ZDOID(VH_ID, 0);
 	for(;;) {
@@ -224,9 +726,8 @@ ZDO& IZDOManager::Instantiate(Vector3f position) {
 
 		auto&& zdo = pair.first->second;
 
-		zdo = std::make_unique<ZDO>(zdoid, position);
-		AddZDOToZone(*zdo.get());
-		return *zdo.get();
+		zdo = m_pool.New(zdoid, position);
+		return *zdo;
 	}
 }
 
@@ -241,19 +742,19 @@ ZDO& IZDOManager::Instantiate(ZDOID uid, Vector3f position) {
 	if (!pair.second) // if insert failed, throw
 		throw std::runtime_error("zdo id already exists");
 
-	auto&& zdo = pair.first->second; zdo = std::make_unique<ZDO>(uid, position);
+	auto&& zdo = pair.first->second; zdo = m_pool.New(uid, position);
 
-	AddZDOToZone(*zdo.get());
-	//m_objectsByPrefab[zdo->PrefabHash()].insert(zdo.get());
+	AddZDOToZone(*zdo);
+	//m_objectsByPrefab[zdo->PrefabHash()].insert(zdo);
 
-	return *zdo.get();
+	return *zdo;
 }
 
 ZDO* IZDOManager::GetZDO(ZDOID id) {
 	if (id) {
 		auto&& find = m_objectsByID.find(id);
 		if (find != m_objectsByID.end())
-			return find->second.get();
+			return find->second;
 	}
 	return nullptr;
 }
@@ -268,7 +769,7 @@ std::pair<decltype(IZDOManager::m_objectsByID)::iterator, bool> IZDOManager::Get
 
 	auto&& zdo = pair.first->second;
 
-	zdo = std::make_unique<ZDO>(id, def);
+	zdo = m_pool.New(id, def);
 	return pair;
 }
 
@@ -279,6 +780,11 @@ ZDO& IZDOManager::Instantiate(const Prefab& prefab, Vector3f pos, Quaternion rot
 	zdo.m_rotation = rot;
 	zdo.m_prefab = prefab;
 
+	// Indexed only once the prefab is known
+	AddZDOToZone(zdo);
+	AddZDOToOwner(zdo);
+	m_objectsByPrefab[prefab.m_hash].insert(&zdo);
+
 	if (prefab.AllFlagsPresent(Prefab::Flag::SYNC_INITIAL_SCALE))
 		zdo.Set("scale", prefab.m_localScale);
 
@@ -296,92 +802,133 @@ ZDO& IZDOManager::Instantiate(const ZDO& zdo) {
 	auto&& copy = Instantiate(zdo.m_prefab, zdo.m_pos, zdo.m_rotation);
 
 	ZDOID temp = copy.ID(); // Copying copies everything (including UID, which MUST be unique for every ZDO)
+	auto owner = copy.Owner();
 	copy = zdo;
 	copy.m_id = temp;
+	ReindexOwner(copy, owner);
 
 	return copy;
 }
 
 
 
-void IZDOManager::AssignOrReleaseZDOs(Peer& peer) {
+bool IZDOManager::CanAssignZDOs(Peer& peer) {
+#ifdef VH_OPTION_ENABLE_CAPTURE
+	if (VH_SETTINGS.packetMode == PacketMode::PLAYBACK
+		&& !std::dynamic_pointer_cast<ReplaySocket>(peer.m_socket))
+		return false;
+#endif
+	return !peer.m_gatedPlaythrough;
+}
+
+void IZDOManager::AssignOrReleaseZDOs(const std::vector<Peer*>& peers) {
 	ZoneScoped;
 
-	auto&& zone = IZoneManager::WorldToZonePos(peer.m_pos);
+	static constexpr int OVERLAP = IZoneManager::NEAR_ACTIVE_AREA - 1;
 
-	std::list<std::reference_wrapper<ZDO>> m_tempNearObjects;
-	GetZDOs_Zone(zone, m_tempNearObjects); // get zdos: zone, nearby
-	GetZDOs_NeighborZones(zone, m_tempNearObjects); // get zdos: zone, nearby
+	// Spatial index of the assigning peers
+	UNORDERED_MAP_t<ZoneID, std::vector<Peer*>> peersByZone;
+	// Every zone which is within range of some assigning peer
+	UNORDERED_SET_t<ZoneID> zones;
 
-	for (auto&& ref : m_tempNearObjects) {
-		auto&& zdo = ref.get();
-		if (zdo.m_prefab.get().AnyFlagsAbsent(Prefab::Flag::SESSIONED)) {
-			if (zdo.IsOwner(peer.m_uuid)) {
-				
-				// If peer no longer in area of zdo, unclaim zdo
-				if (!ZoneManager()->ZonesOverlap(zdo.GetZone(), zone)) {
-					zdo.Disown();
-				}
-			}
-			else {
-				// If ZDO no longer has owner, or the owner went far away,
-				//  Then assign this new peer as owner 
-				if (!(zdo.HasOwner() && ZoneManager()->IsPeerNearby(zdo.GetZone(), zdo.Owner()))
-					&& ZoneManager()->ZonesOverlap(zdo.GetZone(), zone)) {
-					
-					zdo.SetOwner(peer.m_uuid);
-				}
+	for (auto&& peer : peers) {
+		auto zone = IZoneManager::WorldToZonePos(peer->m_pos);
+		peersByZone[zone].push_back(peer);
+
+		for (auto z = zone.y - IZoneManager::NEAR_ACTIVE_AREA; z <= zone.y + IZoneManager::NEAR_ACTIVE_AREA; z++) {
+			for (auto x = zone.x - IZoneManager::NEAR_ACTIVE_AREA; x <= zone.x + IZoneManager::NEAR_ACTIVE_AREA; x++) {
+				zones.insert(ZoneID(x, z));
 			}
 		}
 	}
 
-	if (VH_SETTINGS.zdoAssignAlgorithm == AssignAlgorithm::DYNAMIC_RADIUS) {
+	// An owner keeps its ZDOs until it is this far outside of their area
+	//	Prevents ownership from flipping as a peer wanders along a zone border
+	const float extent = OVERLAP * IZoneManager::ZONE_SIZE + IZoneManager::ZONE_SIZE * .5f + VH_SETTINGS.zdoAssignHysteresis;
+
+	std::vector<Peer*> claimers;
+	for (auto&& zone : zones) {
+		auto sector = GetSector(zone);
+		if (!sector)
+			continue;
+
+		// Peers whose area overlaps this zone
+		claimers.clear();
+		for (auto z = zone.y - OVERLAP; z <= zone.y + OVERLAP; z++) {
+			for (auto x = zone.x - OVERLAP; x <= zone.x + OVERLAP; x++) {
+				auto&& find = peersByZone.find(ZoneID(x, z));
+				if (find != peersByZone.end())
+					claimers.insert(claimers.end(), find->second.begin(), find->second.end());
+			}
+		}
 
-		float minSqDist = std::numeric_limits<float>::max();
-		Vector3f closestPos;
+		const auto center = IZoneManager::ZoneToWorldPos(zone);
 
-		// get the distance to the closest peer
-		for (auto&& otherPeer : NetManager()->GetPeers()) {
-			if (otherPeer == &peer)
+		for (auto zdo : sector->m_zdos) {
+			if (zdo->GetPrefab().AllFlagsPresent(Prefab::Flag::SESSIONED))
 				continue;
 
-			if (!ZoneManager()->IsPeerNearby(IZoneManager::WorldToZonePos(otherPeer->m_pos), peer.m_uuid))
-				continue;
+			// Owners are any online peer, including those not assigning
+			Peer* owner = zdo->HasOwner() ? NetManager()->GetPeerByUUID(zdo->Owner()) : nullptr;
 
-			float sqDist = otherPeer->m_pos.SqDistance(peer.m_pos);
-			if (sqDist < minSqDist) {
-				minSqDist = sqDist;
-				closestPos = otherPeer->m_pos;
+			if (owner
+				&& std::abs(owner->m_pos.x - center.x) <= extent
+				&& std::abs(owner->m_pos.z - center.z) <= extent)
+				continue;
 
-				if (minSqDist <= 12 * 12) {
-					break;
+			// The nearest peer claims ZDOs without a nearby owner
+			Peer* claimer = nullptr;
+			float minSqDist = std::numeric_limits<float>::max();
+			for (auto&& peer : claimers) {
+				float sqDist = peer->m_pos.SqDistance(zdo->Position());
+				if (sqDist < minSqDist) {
+					minSqDist = sqDist;
+					claimer = peer;
 				}
 			}
-		}
 
-		if (minSqDist != std::numeric_limits<float>::max() 
-			&& minSqDist > 12 * 12) {
-			// Get zdos immediate to this peer
-			auto zdos = GetZDOs(peer.m_pos,
-				std::sqrt(minSqDist) * 0.5f - 2.f);
+			if (claimer)
+				zdo->SetOwner(claimer->m_uuid);
+			else if (owner)
+				zdo->Disown();
+		}
+	}
 
-			// Basically reassign zdos from another owner to me instead
-			for (auto&& ref : zdos) {
-				auto&& zdo = ref.get();
-				if (zdo.GetPrefab().AnyFlagsAbsent(Prefab::Flag::SESSIONED)
-					&& zdo.m_pos.SqDistance(closestPos) > 12 * 12 // Ensure the ZDO is far from the other player
-					) {
-					zdo.SetOwner(peer.m_uuid);
+	if (VH_SETTINGS.zdoAssignAlgorithm == AssignAlgorithm::DYNAMIC_RADIUS) {
+		for (auto&& peer : peers) {
+			float minSqDist = std::numeric_limits<float>::max();
+			Vector3f closestPos;
+
+			// get the distance to the closest peer
+			NetManager()->ForEachPeer(IZoneManager::WorldToZonePos(peer->m_pos), OVERLAP, [&](Peer& otherPeer) {
+				if (&otherPeer == peer)
+					return;
+
+				float sqDist = otherPeer.m_pos.SqDistance(peer->m_pos);
+				if (sqDist < minSqDist) {
+					minSqDist = sqDist;
+					closestPos = otherPeer.m_pos;
 				}
+			});
+
+			if (minSqDist != std::numeric_limits<float>::max() 
+				&& minSqDist > 12 * 12) {
+				// Basically reassign zdos immediate to this peer from another owner to me instead
+				ForEachZDO(peer->m_pos, std::sqrt(minSqDist) * 0.5f - 2.f, [&](ZDO& zdo) {
+					if (zdo.GetPrefab().AnyFlagsAbsent(Prefab::Flag::SESSIONED)
+						&& zdo.m_pos.SqDistance(closestPos) > 12 * 12 // Ensure the ZDO is far from the other player
+						) {
+						zdo.SetOwner(peer->m_uuid);
+					}
+				});
 			}
 		}
 	}
-
 }
 
 decltype(IZDOManager::m_objectsByID)::iterator IZDOManager::EraseZDO(decltype(IZDOManager::m_objectsByID)::iterator itr) {
-	auto&& zdoid = itr->first;
-	auto&& zdo = itr->second;
+	auto zdoid = itr->first;
+	auto zdo = itr->second;
 
 	// TODO I dont really understand the point of this
 	//if (zdoid.m_uuid == VH_ID && zdoid.m_id >= m_nextUid)
@@ -389,17 +936,27 @@ decltype(IZDOManager::m_objectsByID)::iterator IZDOManager::EraseZDO(decltype(IZ
 
 	//VLOG(2) << "Destroying zdo (" << zdo->GetPrefab().m_name << ")";
 
+	if (m_trackChanges && zdo->GetPrefab().AnyFlagsAbsent(Prefab::Flag::SESSIONED))
+		m_unsavedDestroys.push_back(zdoid);
+
+	m_erasedZDOs.Insert(zdoid, Valhalla()->Time());
+	return UnloadZDO(itr);
+}
+
+decltype(IZDOManager::m_objectsByID)::iterator IZDOManager::UnloadZDO(decltype(IZDOManager::m_objectsByID)::iterator itr) {
+	auto zdo = itr->second;
+
 	RemoveFromSector(*zdo);
+	RemoveFromOwner(*zdo, zdo->Owner());
 	auto&& pfind = m_objectsByPrefab.find(zdo->GetPrefab().m_hash);
-	if (pfind != m_objectsByPrefab.end()) pfind->second.erase(zdo.get());
+	if (pfind != m_objectsByPrefab.end()) pfind->second.erase(zdo);
 
-	// cleans up some zdos
-	for (auto&& peer : NetManager()->GetPeers()) {
-		peer->m_zdos.erase(zdoid);
-	}
+	m_payloads.erase(itr->first);
+	auto next = m_objectsByID.erase(itr);
 
-	m_erasedZDOs.insert(zdoid);
-	return m_objectsByID.erase(itr);
+	// Peers forget the ZDO on their own once its pool slot is freed
+	m_pool.Delete(zdo);
+	return next;
 }
 
 void IZDOManager::EraseZDO(ZDOID zdoid) {
@@ -451,80 +1008,187 @@ void IZDOManager::GetZDOs_DistantZones(ZoneID zone, std::list<std::reference_wra
 	}
 }
 
-std::list<std::pair<std::reference_wrapper<ZDO>, float>> IZDOManager::CreateSyncList(Peer& peer) {
-	auto zone = IZoneManager::WorldToZonePos(peer.m_pos);
+void IZDOManager::FlushDirtyZDOs() {
+	ZoneScoped;
 
-	// Gather all updated ZDO's
-	std::list<std::reference_wrapper<ZDO>> zoneZDOs;
-	std::list<std::reference_wrapper<ZDO>> distantZDOs;
-	GetZDOs_ActiveZones(zone, zoneZDOs, distantZDOs);
+	if (m_trackChanges)
+		m_unsavedZDOs.insert(m_dirtyZDOs.begin(), m_dirtyZDOs.end());
 
-	std::list<std::pair<std::reference_wrapper<ZDO>, float>> result;
+	for (auto&& zdoid : m_dirtyZDOs) {
+		auto zdo = GetZDO(zdoid);
+		if (!zdo)
+			continue;
 
-	// Prepare client-side outdated ZDO's
-	const auto time(Valhalla()->Time());
-	for (auto&& ref : zoneZDOs) {
-		decltype(Peer::m_zdos)::iterator outItr;
-		if (peer.IsOutdatedZDO(ref, outItr)) {
-			auto&& zdo = ref.get();
+		auto sector = GetSector(zdo->GetZone());
+		if (!sector)
+			continue;
 
-			float weight = 150;
-			if (outItr != peer.m_zdos.end())
-				weight = std::min(time - outItr->second.second, 100.f) * 1.5f;
+		const auto seq = ++m_changeSeq;
+		sector->m_seq = seq;
+		sector->m_journal.emplace_back(seq, zdoid);
 
-			result.push_back({ zdo, zdo.Position().SqDistance(peer.m_pos) - weight * weight });
+		// Trim old changes in bulk
+		//	Peers which fell behind the trimmed part rescan the zone instead
+		if (sector->m_journal.size() >= MAX_ZONE_JOURNAL * 2) {
+			auto trimmed = sector->m_journal.size() - MAX_ZONE_JOURNAL;
+			sector->m_journalFloor = sector->m_journal[trimmed - 1].first;
+			sector->m_journal.erase(sector->m_journal.begin(), sector->m_journal.begin() + trimmed);
 		}
 	}
 
-	// Prioritize ZDO's	
-	result.sort([&](const std::pair<std::reference_wrapper<ZDO>, float>& first, const std::pair<std::reference_wrapper<ZDO>, float>& second) {
+	m_dirtyZDOs.clear();
+}
 
-		// Sort in rough order of:
-		//	flag -> type/priority -> distance ASC -> age ASC
+void IZDOManager::PullZoneChanges(Peer& peer, ZoneID zone, bool near) {
+	auto sector = GetSector(zone);
+	if (!sector)
+		return;
+
+	auto&& pair = peer.m_zoneWatermarks.try_emplace(zone);
+	auto&& mark = pair.first->second;
+
+	// Rescan the whole zone if it has never been pulled, if only distant ZDOs
+	//	were being tracked, or if the journal no longer covers the watermark
+	const bool rescan = pair.second
+		|| (near && !mark.m_near)
+		|| mark.m_seq < sector->m_journalFloor;
+
+	if (!rescan && sector->m_seq <= mark.m_seq) {
+		// Non-distant ZDOs queued while near are dropped once the zone is distant,
+		//	so coming back near must rescan even if nothing changed
+		mark.m_near = mark.m_near && near;
+		return;
+	}
 
-		// https://www.reddit.com/r/valheim/comments/mga1iw/understanding_the_new_networking_mechanisms_from/
+	auto&& track = [&](ZDO& zdo) {
+		if ((near || zdo.GetPrefab().AllFlagsPresent(Prefab::Flag::DISTANT))
+			&& peer.IsOutdatedZDO(zdo))
+			peer.m_syncQueue.insert(zdo.ID());
+	};
+
+	if (rescan) {
+		// Only distant ZDOs are synced in far zones
+		auto&& zdos = near ? sector->m_zdos : *sector->GetFlagBucket(Prefab::Flag::DISTANT);
+		for (auto zdo : zdos)
+			track(*zdo);
+	}
+	else {
+		auto&& begin = std::upper_bound(sector->m_journal.begin(), sector->m_journal.end(), mark.m_seq,
+			[](uint64_t seq, const std::pair<uint64_t, ZDOID>& change) { return seq < change.first; });
+
+		for (auto&& itr = begin; itr != sector->m_journal.end(); ++itr) {
+			// ZDOs might have since moved away or been destroyed
+			if (auto zdo = GetZDO(itr->second))
+				track(*zdo);
+		}
+	}
 
-		auto&& a = first.first.get();
-		auto&& b = second.first.get();
+	mark.m_seq = sector->m_seq;
+	mark.m_near = near;
+}
 
-		bool flag = a.GetPrefab().m_type == Prefab::Type::PRIORITIZED && a.HasOwner() && !a.IsOwner(peer.m_uuid);
-		bool flag2 = b.GetPrefab().m_type == Prefab::Type::PRIORITIZED && b.HasOwner() && !b.IsOwner(peer.m_uuid);
+std::vector<std::reference_wrapper<ZDO>> IZDOManager::CreateSyncList(Peer& peer, size_t max) {
+	ZoneScoped;
 
-		if (flag == flag2) {
-			if ((flag && flag2) || a.GetPrefab().m_type == b.GetPrefab().m_type) {
-				return first.second < second.second;
-			}
-			else
-				// > (shows large trees first)
-				// <  (shows smallest, then small trees first)
-				// >= (shows small trees and large trees simultaneously)
+	const auto zone = IZoneManager::WorldToZonePos(peer.m_pos);
 
-				// the problem with seemingly slowly perceived network speed is not with the actual network,
-				// but with the ZDOManager being bottlenecked by the expensive HeightmapBuilder
-				//	(if Heightmap is not ready, vegetation cannot be generated -> ZDOs cannot be sent)
-				//	this only applies to newly generated areas
-				return a.GetPrefab().m_type >= b.GetPrefab().m_type;
+	for (auto z = zone.y - SYNC_DISTANT_RANGE; z <= zone.y + SYNC_DISTANT_RANGE; z++) {
+		for (auto x = zone.x - SYNC_DISTANT_RANGE; x <= zone.x + SYNC_DISTANT_RANGE; x++) {
+			const ZoneID current(x, z);
+			PullZoneChanges(peer, current, ZoneDistance(current, zone) <= IZoneManager::NEAR_ACTIVE_AREA);
 		}
-		else {
-			return flag;
+	}
+
+	struct Candidate {
+		std::reference_wrapper<ZDO> m_zdo;
+		float m_score;
+		bool m_prioritized;
+	};
+
+	std::vector<Candidate> candidates;
+	std::vector<std::reference_wrapper<ZDO>> distant;
+
+	// Only the queued ZDOs need to be checked, rather than every ZDO in range
+	//	Queue entries which are no longer relevant are dropped along the way
+	const auto time(Valhalla()->Time());
+	for (auto&& itr = peer.m_syncQueue.begin(); itr != peer.m_syncQueue.end(); ) {
+		auto zdo = GetZDO(*itr);
+
+		Peer::KnownZDO* known;
+		if (!zdo || !peer.IsOutdatedZDO(*zdo, known)) {
+			itr = peer.m_syncQueue.erase(itr);
+			continue;
 		}
-	});
 
-	// Add a minimum amount of ZDOs
-	if (result.size() < 10) {
-		for (auto&& zdo2 : distantZDOs) {
-			if (peer.IsOutdatedZDO(zdo2)) {
-				result.push_back({ zdo2, 0 });
-			}
+		const auto distance = ZoneDistance(zdo->GetZone(), zone);
+		if (distance <= IZoneManager::NEAR_ACTIVE_AREA) {
+			float weight = 150;
+			if (known)
+				weight = std::min(time - known->m_time, 100.f) * 1.5f;
+
+			candidates.push_back({ *zdo, 
+				zdo->Position().SqDistance(peer.m_pos) - weight * weight,
+				zdo->GetPrefab().m_type == Prefab::Type::PRIORITIZED && zdo->HasOwner() && !zdo->IsOwner(peer.m_uuid)
+			});
 		}
+		else if (distance <= SYNC_DISTANT_RANGE && zdo->GetPrefab().AllFlagsPresent(Prefab::Flag::DISTANT)) {
+			distant.push_back(*zdo);
+		}
+		else {
+			// Out of range; will be queued again if the peer comes back
+			itr = peer.m_syncQueue.erase(itr);
+			continue;
+		}
+
+		++itr;
 	}
 
+	// Forget zones out of range so they are rescanned if the peer comes back
+	//	Otherwise an unchanged zone would be skipped, and the ZDOs dropped above never sent
+	for (auto&& itr = peer.m_zoneWatermarks.begin(); itr != peer.m_zoneWatermarks.end(); ) {
+		if (ZoneDistance(itr->first, zone) > SYNC_DISTANT_RANGE)
+			itr = peer.m_zoneWatermarks.erase(itr);
+		else
+			++itr;
+	}
+
+	// Prioritize ZDO's
+	//	Sort in rough order of:
+	//	flag -> type/priority -> distance ASC -> age ASC
+	//	https://www.reddit.com/r/valheim/comments/mga1iw/understanding_the_new_networking_mechanisms_from/
+
+	// The problem with seemingly slowly perceived network speed is not with the actual network,
+	//	but with the ZDOManager being bottlenecked by the expensive HeightmapBuilder
+	//	(if Heightmap is not ready, vegetation cannot be generated -> ZDOs cannot be sent)
+	//	this only applies to newly generated areas
+	//	Larger types (such as trees) are shown first
+	auto&& compare = [](const Candidate& a, const Candidate& b) {
+		if (a.m_prioritized != b.m_prioritized)
+			return a.m_prioritized;
+
+		if (!a.m_prioritized) {
+			auto&& typeA = a.m_zdo.get().GetPrefab().m_type;
+			auto&& typeB = b.m_zdo.get().GetPrefab().m_type;
+			if (typeA != typeB)
+				return typeA > typeB;
+		}
+
+		return a.m_score < b.m_score;
+	};
+
+	// Only the ZDOs which can fit in this send need to be ordered
+	const auto count = std::min(max, candidates.size());
+	std::partial_sort(candidates.begin(), candidates.begin() + count, candidates.end(), compare);
+
+	std::vector<std::reference_wrapper<ZDO>> result;
+	result.reserve(peer.m_forceSend.size() + count);
+
 	// Add forcible send ZDOs
 	for (auto&& itr = peer.m_forceSend.begin(); itr != peer.m_forceSend.end();) {
 		auto&& zdoid = *itr;
 		auto zdo = GetZDO(zdoid);
 		if (zdo && peer.IsOutdatedZDO(*zdo)) {
-			result.push_front({ *zdo, 0 });
+			result.push_back(*zdo);
 			++itr;
 		}
 		else {
@@ -532,26 +1196,49 @@ std::list<std::pair<std::reference_wrapper<ZDO>, float>> IZDOManager::CreateSync
 		}
 	}
 
+	for (size_t i = 0; i < count; i++)
+		result.push_back(candidates[i].m_zdo);
+
+	// Add a minimum amount of ZDOs
+	if (candidates.size() < 10) {
+		for (size_t i = 0; i < distant.size() && result.size() < max; i++)
+			result.push_back(distant[i]);
+	}
+
 	return result;
 }
 
-void IZDOManager::GetZDOs_Zone(ZoneID sector, std::list<std::reference_wrapper<ZDO>>& objects) {
-	int num = SectorToIndex(sector);
-	if (num != -1) {
-		auto&& obj = m_objectsBySector[num];
-		std::transform(obj.begin(), obj.end(), std::back_inserter(objects), [](ZDO* zdo) { return std::ref(*zdo); });
+const BYTES_t& IZDOManager::GetPayload(const ZDO& zdo) {
+	auto&& pair = m_payloads.try_emplace(zdo.ID());
+	auto&& payload = pair.first->second;
+
+	if (pair.second
+		|| payload.m_dataRev != zdo.m_dataRev
+		|| payload.m_ownerRev != zdo.GetOwnerRevision())
+	{
+		payload.m_dataRev = zdo.m_dataRev;
+		payload.m_ownerRev = zdo.GetOwnerRevision();
+		payload.m_bytes.clear();
+
+		DataWriter writer(payload.m_bytes);
+		zdo.Serialize(writer);
 	}
+
+	payload.m_lastUsed = Valhalla()->Time();
+	return payload.m_bytes;
 }
 
-void IZDOManager::GetZDOs_Distant(ZoneID sector, std::list<std::reference_wrapper<ZDO>>& objects) {
-	auto num = SectorToIndex(sector);
-	if (num != -1) {
-		auto&& list = m_objectsBySector[num];
+void IZDOManager::GetZDOs_Zone(ZoneID zone, std::list<std::reference_wrapper<ZDO>>& objects) {
+	if (auto sector = GetSector(zone)) {
+		auto&& obj = sector->m_zdos;
+		std::transform(obj.begin(), obj.end(), std::back_inserter(objects), [](ZDO* zdo) { return std::ref(*zdo); });
+	}
+}
 
-		for (auto&& zdo : list) {
-			if (zdo->GetPrefab().AllFlagsPresent(Prefab::Flag::DISTANT))
-				objects.push_back(*zdo);
-		}
+void IZDOManager::GetZDOs_Distant(ZoneID zone, std::list<std::reference_wrapper<ZDO>>& objects) {
+	if (auto sector = GetSector(zone)) {
+		auto&& obj = *sector->GetFlagBucket(Prefab::Flag::DISTANT);
+		std::transform(obj.begin(), obj.end(), std::back_inserter(objects), [](ZDO* zdo) { return std::ref(*zdo); });
 	}
 }
 
@@ -571,49 +1258,32 @@ std::list<std::reference_wrapper<ZDO>> IZDOManager::GetZDOs(HASH_t prefab) {
 
 std::list<std::reference_wrapper<ZDO>> IZDOManager::SomeZDOs(Vector3f pos, float radius, size_t max, const std::function<bool(const ZDO&)>& pred) {
 	std::list<std::reference_wrapper<ZDO>> out;
+	if (!max)
+		return out;
 
-	const float sqRadius = radius * radius;
-
-	auto minZone = IZoneManager::WorldToZonePos(Vector3f(pos.x - radius, 0, pos.z - radius));
-	auto maxZone = IZoneManager::WorldToZonePos(Vector3f(pos.x + radius, 0, pos.z + radius));
-
-	for (auto z = minZone.y; z <= maxZone.y; z++) {
-		for (auto x = minZone.x; x <= maxZone.x; x++) {
-			int num = SectorToIndex({ x, z });
-			if (num != -1) {
-				auto&& objects = m_objectsBySector[num];
-				for (auto&& obj : objects) {
-					if (obj->m_pos.SqDistance(pos) <= sqRadius
-						&& (!pred || pred(*obj)))
-					{
-						if (max--)
-							out.push_back(*obj);
-						else
-							return out;
-					}
-				}
-			}
-		}
-	}
+	ForEachZDO(pos, radius, [&](ZDO& zdo) {
+		if (pred && !pred(zdo))
+			return true;
+
+		out.push_back(zdo);
+		return --max != 0;
+	});
 
 	return out;
 }
 
 std::list<std::reference_wrapper<ZDO>> IZDOManager::SomeZDOs(ZoneID zone, size_t max, const std::function<bool(const ZDO&)>& pred) {
 	std::list<std::reference_wrapper<ZDO>> out;
+	if (!max)
+		return out;
 
-	int num = SectorToIndex(zone);
-	if (num != -1) {
-		auto&& objects = m_objectsBySector[num];
-		for (auto&& obj : objects) {
-			if (!pred || pred(*obj)) {
-				if (max--)
-					out.push_back(*obj);
-				else
-					return out;
-			}
-		}
-	}
+	ForEachZDO(zone, [&](ZDO& zdo) {
+		if (pred && !pred(zdo))
+			return true;
+
+		out.push_back(zdo);
+		return --max != 0;
+	});
 
 	return out;
 }
@@ -621,36 +1291,9 @@ std::list<std::reference_wrapper<ZDO>> IZDOManager::SomeZDOs(ZoneID zone, size_t
 
 
 ZDO* IZDOManager::NearestZDO(Vector3f pos, float radius, const std::function<bool(const ZDO&)>& pred) {
-	//std::list<std::reference_wrapper<ZDO>> out;
-
-	const float sqRadius = radius * radius;
-
-	ZDO* zdo = nullptr;
-	float minSqDist = std::numeric_limits<float>::max();
-
-	auto minZone = IZoneManager::WorldToZonePos(Vector3f(pos.x - radius, 0, pos.z - radius));
-	auto maxZone = IZoneManager::WorldToZonePos(Vector3f(pos.x + radius, 0, pos.z + radius));
-
-	for (auto z = minZone.y; z <= maxZone.y; z++) {
-		for (auto x = minZone.x; x <= maxZone.x; x++) {
-			int num = SectorToIndex({ x, z });
-			if (num != -1) {
-				auto&& objects = m_objectsBySector[num];
-				for (auto&& obj : objects) {
-					float sqDist = obj->m_pos.SqDistance(pos);
-					if (sqDist <= sqRadius // Filter to ZDO within radius
-						&& sqDist < minSqDist // Filter to closest ZDO
-						&& (!pred || pred(*obj)))
-					{
-						zdo = obj;
-						minSqDist = sqDist;
-					}
-				}
-			}
-		}
-	}
-
-	return zdo;
+	return FindNearestZDO(pos, radius, [&](const ZDO& zdo) {
+		return !pred || pred(zdo);
+	});
 }
 
 
@@ -678,21 +1321,57 @@ int IZDOManager::SectorToIndex(ZoneID s) const {
 	return y * IZoneManager::WORLD_DIAMETER_IN_ZONES + x;
 }
 
-bool IZDOManager::SendZDOs(Peer& peer, bool flush) {
-	ZoneScoped;
-
+size_t IZDOManager::GetSyncCapacity(Peer& peer, bool flush) {
 	auto sendQueueSize = peer.m_socket->GetSendQueueSize();
 
 	// flushing forces a packet send
 	const auto threshold = VH_SETTINGS.zdoMaxCongestion;
 	if (!flush && sendQueueSize > threshold)
-		return false;
+		return 0;
 
 	auto availableSpace = threshold - sendQueueSize;
 	if (availableSpace < VH_SETTINGS.zdoMinCongestion)
+		return 0;
+
+	return availableSpace;
+}
+
+bool IZDOManager::SendZDOs(Peer& peer, bool flush) {
+	ZoneScoped;
+
+	auto availableSpace = GetSyncCapacity(peer, flush);
+	if (!availableSpace)
 		return false;
 
-	auto syncList = CreateSyncList(peer);
+	auto syncList = CreateSyncList(peer, availableSpace / MIN_SYNC_ZDO_SIZE + 1);
+
+	return SendSyncList(peer, syncList, availableSpace);
+}
+
+void IZDOManager::SendZDOs(const std::vector<Peer*>& peers) {
+	ZoneScoped;
+
+	// Sockets are only queried from the main thread
+	m_syncPlans.clear();
+	for (auto&& peer : peers) {
+		if (auto availableSpace = GetSyncCapacity(*peer, false))
+			m_syncPlans.push_back({ peer, availableSpace, {} });
+	}
+
+	// Nothing else touches ZDOs or sectors until planning is done,
+	//	and each plan only modifies the state of its own peer
+	m_syncWorkers.Run(m_syncPlans.size(), [this](size_t i) {
+		auto&& plan = m_syncPlans[i];
+		plan.m_syncList = CreateSyncList(*plan.m_peer, plan.m_availableSpace / MIN_SYNC_ZDO_SIZE + 1);
+	});
+
+	// Packets and mod events must be dispatched serially
+	for (auto&& plan : m_syncPlans)
+		SendSyncList(*plan.m_peer, plan.m_syncList, plan.m_availableSpace);
+}
+
+bool IZDOManager::SendSyncList(Peer& peer, const std::vector<std::reference_wrapper<ZDO>>& syncList, size_t availableSpace) {
+	ZoneScoped;
 
 	// continue only if there are updated/invalid NetSyncs to send
 	if (syncList.empty() && peer.m_invalidSector.empty())
@@ -703,7 +1382,7 @@ bool IZDOManager::SendZDOs(Peer& peer, bool flush) {
 	//	to avoid a few buffer allocs
 	//	this only matters if performance is upmost concern, which it is because c :>
 
-	peer.SubInvoke(Hashes::Rpc::ZDOData, [&peer, &syncList, availableSpace](DataWriter& writer) {
+	peer.SubInvoke(Hashes::Rpc::ZDOData, [this, &peer, &syncList, availableSpace](DataWriter& writer) {
 		writer.Write(peer.m_invalidSector);
 
 		const auto time = Valhalla()->Time();
@@ -712,7 +1391,7 @@ bool IZDOManager::SendZDOs(Peer& peer, bool flush) {
 			itr != syncList.end() && writer.size() <= availableSpace;
 			itr++) {
 
-			auto&& zdo = itr->first.get();
+			auto&& zdo = itr->get();
 
 			peer.m_forceSend.erase(zdo.ID());
 
@@ -726,14 +1405,14 @@ bool IZDOManager::SendZDOs(Peer& peer, bool flush) {
 			writer.Write(zdo.Owner());
 			writer.Write(zdo.m_pos);
 
-			writer.SubWrite([&zdo](DataWriter& writer) {
-				zdo.Serialize(writer);
-				});
+			// Serialized once and shared by every peer (identical to a SubWrite)
+			writer.Write(GetPayload(zdo));
 
-			peer.m_zdos[zdo.ID()] = { ZDO::Rev{
+			peer.SetKnownZDO(zdo, ZDO::Rev{
 				.m_dataRev = zdo.m_dataRev,
 				.m_ownerRev = zdo.GetOwnerRevision()
-			}, time };
+			}, time);
+			peer.m_syncQueue.erase(zdo.ID());
 		}
 		writer.Write(ZDOID::NONE); // null terminator
 	});
@@ -787,7 +1466,7 @@ void IZDOManager::OnNewPeer(Peer& peer) {
 
 			auto&& pair = this->GetOrInstantiate(zdoid, pos);
 
-			auto&& zdo = *pair.first->second.get();
+			auto&& zdo = *pair.first->second;
 			auto&& created = pair.second;
 
 			if (!created) {
@@ -799,17 +1478,19 @@ void IZDOManager::OnNewPeer(Peer& peer) {
 					if (ownerRev > zdo.GetOwnerRevision()) {
 						zdo._SetOwner(owner);
 						zdo.SetOwnerRevision(ownerRev);
-						peer->m_zdos[zdoid] = { 
+						MarkDirty(zdo);
+						peer->SetKnownZDO(zdo,
 							ZDO::Rev {.m_dataRev = dataRev, .m_ownerRev = ownerRev}, 
 							time 
-						};
+						);
 					}
 					continue;
 				}
 			}
 			else {
-				if (m_erasedZDOs.contains(zdoid)) {
+				if (m_erasedZDOs.Contains(zdoid)) {
 					m_destroySendList.push_back(zdoid);
+					m_pool.Delete(pair.first->second);
 					m_objectsByID.erase(pair.first);
 					continue;
 				}
@@ -836,27 +1517,35 @@ void IZDOManager::OnNewPeer(Peer& peer) {
 					}
 
 					AddZDOToZone(zdo);
+					AddZDOToOwner(zdo);
 					m_objectsByPrefab[zdo.GetPrefab().m_hash].insert(&zdo);
 				}
 				else {
 					if (!VH_DISPATCH_MOD_EVENT(IModManager::Events::ZDOModified, peer, zdo, copy, pos)) {
+						auto owner = zdo.Owner();
 						zdo = std::move(copy);
+						ReindexOwner(zdo, owner);
 						continue;
 					}
 
 					zdo.SetPosition(pos);
+					MarkDirty(zdo);
 				}
 
-				peer->m_zdos[zdoid] = {
+				peer->SetKnownZDO(zdo,
 					ZDO::Rev{ .m_dataRev = zdo.m_dataRev, .m_ownerRev = zdo.GetOwnerRevision() },
 					time 
-				};
+				);
 			}
 			catch (const std::runtime_error& e) {
 				// erase the zdo from map
 				if (created) // if the zdo was just created, throw it away
 					EraseZDO(pair.first);
-				else zdo = copy; // else, restore the ZDO to the prior revision
+				else { // else, restore the ZDO to the prior revision
+					auto owner = zdo.Owner();
+					zdo = copy;
+					ReindexOwner(zdo, owner);
+				}
 
 				// This will kick the malicious peer
 				std::rethrow_exception(std::make_exception_ptr(e));
@@ -866,26 +1555,28 @@ void IZDOManager::OnNewPeer(Peer& peer) {
 }
 
 void IZDOManager::OnPeerQuit(Peer& peer) {
-	for (auto&& itr = m_objectsByID.begin(); itr != m_objectsByID.end(); ) {
-		auto&& pair = *itr;
+	ZoneScoped;
+
+	// Only ZDOs owned by this peer, by nobody, or by peers
+	//	which are gone need to be checked
+	std::vector<ZDOID> destroy;
+	for (auto&& pair : m_objectsByOwner) {
+		auto&& owner = pair.first;
+		if (owner && owner != peer.m_uuid && NetManager()->GetPeerByUUID(owner))
+			continue;
 
-		auto&& zdo = *pair.second.get();
-		auto&& prefab = zdo.GetPrefab();
-		
 		// Apparently peer does unclaim sessioned ZDOs (Player zdo had 0 owner)
 		//assert((prefab.FlagsAbsent(Prefab::Flag::SESSIONED) || zdo.HasOwner()) && "Session ZDOs should always be owned");
 
 		// Remove temporary ZDOs belonging to peers (like particles and attack anims, vfx, sfx...)
-		//if (prefab.FlagsPresent(Prefab::Flag::SESSIONED)
-			//&& (zdo.IsOwner(peer.m_uuid)))
-		if (prefab.AllFlagsPresent(Prefab::Flag::SESSIONED) 
-			&& (!zdo.HasOwner() || zdo.IsOwner(peer.m_uuid) || !NetManager()->GetPeerByUUID(zdo.Owner())))
-		{
-			itr = DestroyZDO(itr);
+		for (auto&& zdo : pair.second) {
+			if (zdo->GetPrefab().AllFlagsPresent(Prefab::Flag::SESSIONED))
+				destroy.push_back(zdo->ID());
 		}
-		else
-			++itr;
 	}
+
+	for (auto&& zdoid : destroy)
+		DestroyZDO(zdoid);
 }
 
 void IZDOManager::DestroyZDO(ZDOID zdoid) {
@@ -925,7 +1616,7 @@ float IZDOManager::GetStDevZDOMembers() {
 }
 
 size_t IZDOManager::GetTotalZDOAlloc() {
-	size_t bytes = m_objectsByID.size() * sizeof(ZDO);
+	size_t bytes = m_pool.GetTotalAlloc() + m_strings.GetTotalAlloc() + m_bytes.GetTotalAlloc() + m_erasedZDOs.GetTotalAlloc();
 	for (auto&& pair : m_objectsByID) bytes += pair.second->GetTotalAlloc();
 	return bytes;
 }
@@ -286,6 +286,36 @@ void IZoneManager::Save(DataWriter& pkg) {
     }
 }
 
+// public
+void IZoneManager::TrackChanges() {
+    m_unsavedZones.clear();
+    m_savedGlobalKeys = m_globalKeys;
+    m_trackChanges = true;
+}
+
+// public
+void IZoneManager::SaveChanges(DataWriter& writer) {
+    writer.Write(m_unsavedZones);
+    m_unsavedZones.clear();
+
+    const bool keysChanged = m_globalKeys != m_savedGlobalKeys;
+    writer.Write(keysChanged);
+    if (keysChanged) {
+        writer.Write(m_globalKeys);
+        m_savedGlobalKeys = m_globalKeys;
+    }
+}
+
+// public
+void IZoneManager::LoadChanges(DataReader& reader) {
+    reader.AsEach([this](ZoneID zone) {
+        m_generatedZones.insert(zone);
+    });
+
+    if (reader.Read<bool>())
+        m_globalKeys = reader.Read<decltype(m_globalKeys)>();
+}
+
 // public
 void IZoneManager::Load(DataReader& reader, int32_t version) {
     m_generatedZones = reader.Read<decltype(m_generatedZones)>();
@@ -406,6 +436,9 @@ bool IZoneManager::GenerateZone(ZoneID zone) {
     {
         auto&& pair = m_generatedZones.insert(zone);
         if (pair.second) {
+            if (m_trackChanges)
+                m_unsavedZones.push_back(zone);
+
             PopulateZone(HeightmapManager()->GetHeightmap(zone));
             return true;
         }
@@ -419,6 +452,8 @@ bool IZoneManager::TryGenerateZone(ZoneID zone) {
         && !IsZoneGenerated(zone)) {
         if (auto heightmap = HeightmapManager()->PollHeightmap(zone)) {
             m_generatedZones.insert(zone);
+            if (m_trackChanges)
+                m_unsavedZones.push_back(zone);
 
             PopulateZone(*heightmap);
 
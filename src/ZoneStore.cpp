@@ -0,0 +1,144 @@
+#include "ZoneStore.h"
+
+// Zones are paged often, so favour speed over ratio
+static constexpr int PAGE_COMPRESSION_LEVEL = 1;
+
+// Garbage below this is not worth rewriting the file for
+static constexpr uint64_t COMPACT_THRESHOLD = 64ULL * 1024 * 1024;
+
+static bool Seek(FILE* file, uint64_t offset) {
+#ifdef _WIN32
+    return _fseeki64(file, static_cast<int64_t>(offset), SEEK_SET) == 0;
+#else
+    return fseeko(file, static_cast<off_t>(offset), SEEK_SET) == 0;
+#endif
+}
+
+ZoneStore::ZoneStore(fs::path path)
+    : m_path(std::move(path))
+{
+    m_file = std::fopen(m_path.string().c_str(), "w+b");
+    if (!m_file)
+        throw std::runtime_error("failed to create " + m_path.string());
+}
+
+ZoneStore::~ZoneStore() {
+    if (m_file)
+        std::fclose(m_file);
+
+    std::error_code err;
+    fs::remove(m_path, err);
+}
+
+void ZoneStore::Remove(decltype(m_chunks)::iterator itr) {
+    m_liveSize -= itr->second.m_size;
+    m_count -= itr->second.m_count;
+    m_chunks.erase(itr);
+}
+
+void ZoneStore::Write(Vector2i zone, const BYTES_t& records, uint32_t count) {
+    auto compressed = ZStdCompressor(PAGE_COMPRESSION_LEVEL).Compress(records);
+    if (!compressed)
+        throw std::runtime_error("failed to compress zone");
+
+    if (!Seek(m_file, m_end)
+        || std::fwrite(compressed->data(), 1, compressed->size(), m_file) != compressed->size()
+        || std::fflush(m_file) != 0)
+        throw std::runtime_error("failed to write to " + m_path.string());
+
+    auto find = m_chunks.find(zone);
+    if (find != m_chunks.end())
+        Remove(find);
+
+    Chunk chunk{ m_end, static_cast<uint32_t>(compressed->size()), count };
+    m_chunks[zone] = chunk;
+
+    m_end += chunk.m_size;
+    m_liveSize += chunk.m_size;
+    m_count += count;
+}
+
+std::optional<std::pair<BYTES_t, uint32_t>> ZoneStore::Take(Vector2i zone) {
+    auto find = m_chunks.find(zone);
+    if (find == m_chunks.end())
+        return std::nullopt;
+
+    auto records = Read(m_file, find->second);
+    auto count = find->second.m_count;
+    Remove(find);
+    return std::make_pair(std::move(records), count);
+}
+
+BYTES_t ZoneStore::Read(FILE* file, const Chunk& chunk) {
+    BYTES_t compressed(chunk.m_size);
+    if (!Seek(file, chunk.m_offset)
+        || std::fread(compressed.data(), 1, compressed.size(), file) != compressed.size())
+        throw std::runtime_error("failed to read zone chunk");
+
+    auto records = ZStdDecompressor().Decompress(compressed);
+    if (!records)
+        throw std::runtime_error("failed to decompress zone chunk");
+
+    return std::move(*records);
+}
+
+void ZoneStore::Compact() {
+    const auto garbage = m_end - m_liveSize;
+    if (garbage < COMPACT_THRESHOLD || garbage < m_liveSize)
+        return;
+
+    // A save is still reading the old offsets
+    if (m_pin.use_count() > 1)
+        return;
+
+    auto temp = m_path;
+    temp += ".tmp";
+
+    FILE* file = std::fopen(temp.string().c_str(), "w+b");
+    if (!file)
+        throw std::runtime_error("failed to create " + temp.string());
+
+    decltype(m_chunks) chunks;
+    chunks.reserve(m_chunks.size());
+
+    uint64_t end = 0;
+    BYTES_t compressed;
+    for (auto&& [zone, chunk] : m_chunks) {
+        compressed.resize(chunk.m_size);
+        if (!Seek(m_file, chunk.m_offset)
+            || std::fread(compressed.data(), 1, compressed.size(), m_file) != compressed.size()
+            || std::fwrite(compressed.data(), 1, compressed.size(), file) != compressed.size())
+        {
+            std::fclose(file);
+            fs::remove(temp);
+            throw std::runtime_error("failed to compact " + m_path.string());
+        }
+
+        chunks[zone] = Chunk{ end, chunk.m_size, chunk.m_count };
+        end += chunk.m_size;
+    }
+
+    std::fclose(m_file);
+    m_file = nullptr;
+
+    std::fflush(file);
+    std::fclose(file);
+    fs::rename(temp, m_path);
+
+    m_file = std::fopen(m_path.string().c_str(), "r+b");
+    if (!m_file)
+        throw std::runtime_error("failed to reopen " + m_path.string());
+
+    LOG_INFO(LOGGER, "Compacted zone paging file ({}kb -> {}kb)", m_end / 1000, end / 1000);
+
+    m_chunks = std::move(chunks);
+    m_end = end;
+}
+
+std::vector<ZoneStore::Chunk> ZoneStore::Chunks() const {
+    std::vector<Chunk> chunks;
+    chunks.reserve(m_chunks.size());
+    for (auto&& pair : m_chunks)
+        chunks.push_back(pair.second);
+    return chunks;
+}